@@ -0,0 +1,98 @@
+#ifndef COLOR_MATH_H
+#define COLOR_MATH_H
+
+#include <NeoPixelBus.h>
+
+// Q16 fixed point fractions, 0 is 0.0 and Q16One is 1.0. The S2 has no FPU,
+// so anything evaluated per pixel per frame is kept in integers.
+const uint32_t Q16One = 65536;
+
+typedef float (*EaseFunction)(float unitValue);
+
+// A 32-bit word the compiler knows may overlap 16-bit channels, for the
+// loops that work on two channels at once
+typedef uint32_t __attribute__((__may_alias__)) ChannelPair;
+
+// A colour with 16 bits per channel, what the frame buffer holds so fades
+// keep their precision until the output stage dithers them down to 8 bits
+struct FrameColor {
+    FrameColor() :
+        R(0), G(0), B(0) {
+    }
+
+    FrameColor(uint16_t r, uint16_t g, uint16_t b) :
+        R(r), G(g), B(b) {
+    }
+
+    // 255 becomes 65535 so full brightness stays full brightness
+    FrameColor(const RgbColor& color) :
+        R(color.R * 257), G(color.G * 257), B(color.B * 257) {
+    }
+
+    // nearest 8 bit colour
+    RgbColor ToRgbColor() const {
+        return RgbColor(To8Bit(R), To8Bit(G), To8Bit(B));
+    }
+
+    static uint8_t To8Bit(uint16_t value) {
+        return (value * 255U + 32767U) / 65535U;
+    }
+
+    uint16_t R;
+    uint16_t G;
+    uint16_t B;
+};
+
+// Integer version of RgbColor::LinearBlend, weight is a Q16 fraction of
+// the way from left to right and rounds the same way as the float blend
+inline RgbColor BlendColor(const RgbColor& left, const RgbColor& right, uint32_t weight) {
+    return RgbColor(
+        left.R + ((static_cast<int32_t>(right.R) - left.R) * static_cast<int32_t>(weight) >> 16),
+        left.G + ((static_cast<int32_t>(right.G) - left.G) * static_cast<int32_t>(weight) >> 16),
+        left.B + ((static_cast<int32_t>(right.B) - left.B) * static_cast<int32_t>(weight) >> 16));
+}
+
+// The same blend at 16 bits per channel. The Q16 weight is halved so the
+// product of a full scale difference still fits in 32 bits.
+inline uint16_t BlendChannel(uint16_t left, uint16_t right, uint32_t weight) {
+    return left + ((static_cast<int32_t>(right) - left) * static_cast<int32_t>(weight >> 1) >> 15);
+}
+
+inline FrameColor BlendColor(const FrameColor& left, const FrameColor& right, uint32_t weight) {
+    return FrameColor(
+        BlendChannel(left.R, right.R, weight),
+        BlendChannel(left.G, right.G, weight),
+        BlendChannel(left.B, right.B, weight));
+}
+
+// Subtract darkenBy from every channel, stopping at 0, the raw buffer
+// version of RgbColor::Darken. Works a 32-bit word (two channels) at a time.
+void DarkenChannels(uint16_t* channels, size_t count, uint16_t darkenBy);
+
+// An easing curve sampled once at start up and linearly interpolated, so
+// easing a pixel costs two table reads and a multiply instead of float maths
+class EaseTable {
+public:
+    EaseTable(EaseFunction curve);
+
+    // progress and the result are both Q16 fractions
+    uint32_t Ease(uint32_t progress) const {
+        if (progress >= Q16One) {
+            return _values[Segments];
+        }
+        uint32_t index = progress >> FractionBits;
+        int32_t fraction = progress & ((1 << FractionBits) - 1);
+        int32_t start = _values[index];
+        int32_t end = _values[index + 1];
+        return start + ((end - start) * fraction >> FractionBits);
+    }
+
+private:
+    static const uint8_t SegmentBits = 6; // 64 segments keep the error well under one colour step
+    static const uint8_t FractionBits = 16 - SegmentBits;
+    static const uint16_t Segments = 1 << SegmentBits;
+
+    uint32_t _values[Segments + 1];
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// A change to what is shown, sent from the web server to the render loop
+enum CommandType : uint8_t {
+    Command_SetEffect,     // value is the animation number, 0 is off
+    Command_SetColour,     // value is 0xRRGGBB
+    Command_SetSpeed,      // value is percent of normal speed
+    Command_SetBrightness, // value is 0 to 255
+    Command_SetGamma,      // value is the gamma in thousandths
+    Command_SetWhiteBalance, // value is 0xRRGGBB
+    Command_SetDither,     // value is 0 or 1
+    Command_SetTransition, // value is the cross fade time in ms
+    Command_SetEffectSpeed, // value is percent of normal speed for the selected effect
+    Command_SetLayout      // value is unused, the layout is the one setStripLayout() was given
+};
+
+const uint8_t CommandTypeCount = Command_SetLayout + 1;
+
+struct Command {
+    CommandType type;
+    uint32_t value;
+};
+
+// Fixed size ring for exactly one task pushing and one task popping. Each
+// side only ever writes its own index, so neither takes a lock or waits
+// on the other: a full ring makes Push() fail rather than block, and an
+// empty one makes Pop() return straight away. Size must be a power of two.
+template <typename T, uint32_t Size> class CommandQueue {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "Size must be a power of two");
+
+public:
+    CommandQueue() :
+        _head(0),
+        _tail(0) {
+    }
+
+    // producer only, returns false if the ring is full
+    bool Push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == Size) {
+            return false;
+        }
+        _items[head & (Size - 1)] = item;
+        // the item is written before the consumer can see the new head
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, returns false if the ring is empty
+    bool Pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail & (Size - 1)];
+        // the item is read before the producer can reuse its slot
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T _items[Size];
+    // both only ever count up, the difference is how many are queued
+    std::atomic<uint32_t> _head;
+    std::atomic<uint32_t> _tail;
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef EFFECT_ENGINE_H
+#define EFFECT_ENGINE_H
+
+#include <NeoPixelBus.h>
+#include <NeoPixelAnimator.h>
+#include <ColorMath.h>
+#include <new>
+
+// Fixed block of memory all of the active effect's state is carved from.
+// Switching effects destroys the old one and resets the arena, so only
+// one effect is ever resident and nothing is left behind on the heap.
+class EffectArena {
+public:
+    EffectArena(uint8_t* memory, size_t size);
+
+    // returns NULL once the arena is exhausted
+    void* Allocate(size_t size, size_t alignment);
+
+    template <typename T> T* Allocate(size_t count = 1) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void Reset();
+
+    size_t Used() const {
+        return _used;
+    }
+
+    size_t Size() const {
+        return _size;
+    }
+
+private:
+    uint8_t* _memory;
+    size_t _size;
+    size_t _used;
+};
+
+// Base for everything animationSelector() can play, constructing it sets
+// the effect up and Update() is called once per frame to draw it
+class Effect {
+public:
+    virtual ~Effect() {}
+    virtual void Update() = 0;
+};
+
+// One entry in the effect registry, the position in the table is the
+// animation number the web page selects it with
+struct EffectEntry {
+    const char* name;
+    Effect* (*create)(EffectArena& arena);
+};
+
+// Arena space an effect of type T needs, the object itself plus the
+// StateSize() bytes it allocates for its animations and state on a strip
+// of pixelCount pixels
+template <typename T> constexpr size_t ArenaSizeFor(uint16_t pixelCount) {
+    return sizeof(T) + alignof(T) + T::StateSize(pixelCount);
+}
+
+// Creates an effect of type T inside the arena
+template <typename T> Effect* CreateEffect(EffectArena& arena) {
+    void* memory = arena.Allocate(sizeof(T), alignof(T));
+    if (memory == NULL) {
+        return NULL;
+    }
+    return new (memory) T(arena);
+}
+
+// The time every effect animates by, millis() scaled by a speed so all of
+// them can be slowed down or sped up together without knowing about it,
+// and by a second speed for the effect running, so each can be set to look
+// right on its own. The render loop moves it on once a frame, so everything
+// drawn in one frame sees the same time. A new speed only changes how fast
+// it moves on from here, so running animations carry on from where they
+// are rather than jumping or starting over.
+class EffectClock {
+public:
+    EffectClock();
+
+    void Advance(uint32_t nowMillis);
+
+    uint32_t Millis() const {
+        return _millis;
+    }
+
+    // percent of real time, 100 is normal speed and 0 pauses the effects
+    void SetSpeed(uint16_t percent) {
+        _speed = percent;
+    }
+
+    uint16_t Speed() const {
+        return _speed;
+    }
+
+    // percent on top of Speed() for the effect running now
+    void SetEffectSpeed(uint16_t percent) {
+        _effectSpeed = percent;
+    }
+
+    uint16_t EffectSpeed() const {
+        return _effectSpeed;
+    }
+
+private:
+    uint32_t _lastTick;
+    uint32_t _millis;
+    uint32_t _fraction; // ten thousandths of a ms carried to the next frame
+    uint16_t _speed;
+    uint16_t _effectSpeed;
+    bool _started;
+};
+
+extern EffectClock effectClock;
+
+// Random numbers for the effects, xorshift32 kept inline so a pick costs a
+// few shifts rather than a call into newlib's rand(). Seeding it with the
+// same value replays the same effects, which is how the host runs and tests
+// get repeatable frames.
+class EffectRandom {
+public:
+    explicit EffectRandom(uint32_t seed = 0x9E3779B9) {
+        Seed(seed);
+    }
+
+    // zero would stick xorshift at zero forever, so it is swapped for one
+    void Seed(uint32_t seed) {
+        _state = (seed != 0) ? seed : 1;
+    }
+
+    uint32_t Next() {
+        uint32_t x = _state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        _state = x;
+        return x;
+    }
+
+    // 0 to range - 1, every value equally likely. The top half of a 32 x 32
+    // multiply picks the value, and only the few draws that would favour
+    // the low values are thrown away. Working out which those are takes a
+    // modulo, but only for a draw that lands in the range/2^32 sliver where
+    // it could matter, and with a constant range the compiler folds it away.
+    uint32_t Below(uint32_t range) {
+        uint64_t product = (uint64_t)Next() * range;
+        uint32_t low = (uint32_t)product;
+        if (low < range) {
+            const uint32_t threshold = (0U - range) % range;
+            while (low < threshold) {
+                product = (uint64_t)Next() * range;
+                low = (uint32_t)product;
+            }
+        }
+        return (uint32_t)(product >> 32);
+    }
+
+    // low to high - 1 like Arduino's random(low, high), low if high isn't above it
+    int32_t Between(int32_t low, int32_t high) {
+        if (high <= low) {
+            return low;
+        }
+        return low + (int32_t)Below((uint32_t)(high - low));
+    }
+
+private:
+    uint32_t _state;
+};
+
+extern EffectRandom effectRandom;
+
+// What an update function is told about its animation, progress is a Q16
+// fraction from 0 when started to Q16One when completed
+struct EffectParam {
+    uint32_t progress;
+    uint16_t index;
+    AnimationState state;
+};
+
+// Plain functions used in place of std::function, so nothing is ever
+// captured or copied onto the heap. The context is whatever the animator
+// was created with, normally the effect that owns it.
+typedef void (*AnimUpdateFunction)(void* context, const EffectParam& param);
+
+// Same timing as NeoPixelAnimator, but the animation channels live in the
+// effect arena instead of being allocated from the heap
+class EffectAnimator {
+public:
+    EffectAnimator(EffectArena& arena, void* context, uint16_t countAnimations, uint16_t timeScale = NEO_MILLISECONDS);
+
+    bool IsAnimating() const {
+        return _activeAnimations > 0;
+    }
+
+    bool NextAvailableAnimation(uint16_t* indexAvailable, uint16_t indexStart = 0);
+
+    void StartAnimation(uint16_t indexAnimation, uint16_t duration, AnimUpdateFunction animUpdate);
+    void StopAnimation(uint16_t indexAnimation);
+    void StopAll();
+
+    void RestartAnimation(uint16_t indexAnimation);
+
+    bool IsAnimationActive(uint16_t indexAnimation) const {
+        if (indexAnimation >= _countAnimations) {
+            return false;
+        }
+        return (IsAnimating() && _animations[indexAnimation].remaining != 0);
+    }
+
+    void UpdateAnimations();
+
+    // arena space needed for a given number of channels
+    static constexpr size_t ArenaSize(uint16_t countAnimations) {
+        return sizeof(AnimationContext) * countAnimations + alignof(AnimationContext);
+    }
+
+private:
+    struct AnimationContext {
+        uint16_t duration;
+        uint16_t remaining;
+        AnimUpdateFunction fnCallback;
+    };
+
+    void* _context;
+    uint16_t _countAnimations;
+    AnimationContext* _animations;
+    uint32_t _animationLastTick;
+    uint16_t _activeAnimations;
+    uint16_t _timeScale;
+};
+
+#endif
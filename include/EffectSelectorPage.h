@@ -6,9 +6,12 @@
 
 void startWebServer();
 
-String processor(const String& var);
+// Sends the state to every control socket client if it changed since the
+// last time, call it from loop()
+void pushState();
 
-int getAnimation();
+// Call once each time round loop(), /metrics reports how often it runs
+void countLoop();
 
 
 #endif
\ No newline at end of file
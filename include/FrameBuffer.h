@@ -0,0 +1,114 @@
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <NeoPixelBus.h>
+#include <ColorMath.h>
+#include <StripDescriptor.h>
+
+// Pixels as the effects see them, 16 bits per channel in wire colour order
+// so slow fades keep their precision until the output stage dithers them
+// down to what the strip takes. Effects draw in logical coordinates and
+// rotating the strip just moves the head index, the offset is applied when
+// the frame is copied out to the strip so it costs the same at any length.
+// Only red, green and blue are kept, on an RGBW strip the output stage
+// works out the white channel.
+class FrameBuffer {
+public:
+    static const uint8_t ChannelsPerPixel = 3;
+    // where each colour sits in a pixel, the wire order of the strip
+    static const uint8_t Red = Strip::Order::Red;
+    static const uint8_t Green = Strip::Order::Green;
+    static const uint8_t Blue = Strip::Order::Blue;
+
+    // channels must hold count * ChannelsPerPixel values, word aligned
+    FrameBuffer(uint16_t* channels, uint16_t count);
+
+    uint16_t PixelCount() const {
+        return _count;
+    }
+
+    uint16_t* Channels() {
+        return _channels;
+    }
+
+    const uint16_t* Channels() const {
+        return _channels;
+    }
+
+    size_t ChannelCount() const {
+        return _count * ChannelsPerPixel;
+    }
+
+    void SetPixelColor(uint16_t index, const FrameColor& color) {
+        if (index < _count) {
+            uint16_t* pixel = _channels + index * ChannelsPerPixel;
+            pixel[Red] = color.R;
+            pixel[Green] = color.G;
+            pixel[Blue] = color.B;
+            _dirty = true;
+        }
+    }
+
+    FrameColor GetPixelColor16(uint16_t index) const {
+        if (index < _count) {
+            const uint16_t* pixel = _channels + index * ChannelsPerPixel;
+            return FrameColor(pixel[Red], pixel[Green], pixel[Blue]);
+        }
+        return FrameColor();
+    }
+
+    RgbColor GetPixelColor(uint16_t index) const {
+        return GetPixelColor16(index).ToRgbColor();
+    }
+
+    // Set a run of pixels to one colour a word at a time
+    void Fill(const FrameColor& color, uint16_t first, uint16_t count);
+
+    // Every channel of every pixel towards black, saturating at zero
+    void Darken(uint16_t darkenBy);
+
+    // Move the whole picture along the strip, wrapping at the ends
+    void RotateRight(uint16_t rotationCount);
+    void RotateLeft(uint16_t rotationCount);
+
+    // Where logical pixel 0 lands on the strip
+    uint16_t Offset() const {
+        return _offset;
+    }
+
+    // Moves the pixels so logical and strip positions are the same again,
+    // this is the one place rotation costs a pass over the buffer
+    void Normalise();
+
+    // Becomes a copy of other, which must have the same pixel count
+    void CopyFrom(const FrameBuffer& other);
+
+    // Moves every channel a Q16 weight of the way toward other, both must
+    // have the same pixel count and be normalised
+    void BlendToward(const FrameBuffer& other, uint32_t weight);
+
+    bool IsDirty() const {
+        return _dirty;
+    }
+
+    void Dirty() {
+        _dirty = true;
+    }
+
+    void ResetDirty() {
+        _dirty = false;
+    }
+
+    // The logical pixel shown at stripIndex
+    uint16_t LogicalIndex(uint16_t stripIndex) const {
+        return (stripIndex + _count - _offset) % _count;
+    }
+
+private:
+    uint16_t* _channels;
+    uint16_t _count;
+    uint16_t _offset;
+    bool _dirty;
+};
+
+#endif
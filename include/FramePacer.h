@@ -0,0 +1,33 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <Arduino.h>
+
+// Keeps frames on a fixed deadline grid so the frame rate doesn't drift
+// with how long each frame or anything else on the CPU takes.
+// Frames that can't be made are counted as dropped and skipped, rather
+// than rendered back to back to catch up.
+class FramePacer {
+public:
+    FramePacer(uint16_t targetFps = 60);
+
+    void setTargetFps(uint16_t targetFps);
+    uint16_t getTargetFps() const;
+
+    // Microseconds until the next frame is due, 0 when it is due now
+    uint32_t timeUntilDue(uint32_t nowMicros) const;
+
+    // Call when starting a frame, moves the deadline on by one frame
+    void frameStarted(uint32_t nowMicros);
+
+    uint32_t getDroppedFrames() const;
+
+private:
+    uint16_t _targetFps;
+    uint32_t _interval;
+    uint32_t _deadline;
+    uint32_t _dropped;
+    bool _started;
+};
+
+#endif
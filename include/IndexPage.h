@@ -0,0 +1,120 @@
+// Generated from web/index.html by web/embed_page.py, edit the page and rebuild
+#ifndef INDEX_PAGE_H
+#define INDEX_PAGE_H
+
+#include <Arduino.h>
+
+const char IndexPageETag[] = "\"af86c6040ecd91a3\"";
+const size_t IndexPageSize = 1722;
+const uint8_t IndexPage[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x57, 0x6d, 0x73, 0xdb, 0x36,
+    0x0c, 0xfe, 0xee, 0x5f, 0x81, 0xa9, 0x1f, 0x2a, 0x2f, 0xb6, 0xec, 0x38, 0x49, 0xd7, 0xf3, 0xdb,
+    0xae, 0x2f, 0xb9, 0x5b, 0x77, 0xeb, 0xcb, 0x5d, 0xba, 0x75, 0xbb, 0xa6, 0x1f, 0x28, 0x89, 0xb2,
+    0xd8, 0xd0, 0xa4, 0x46, 0x52, 0x76, 0xbc, 0x9c, 0xff, 0xfb, 0x00, 0x52, 0x96, 0xed, 0xa4, 0xcd,
+    0x6d, 0xf9, 0x90, 0x50, 0x20, 0x80, 0xe7, 0x01, 0x08, 0x80, 0xcc, 0xf4, 0x87, 0xd7, 0xef, 0x5f,
+    0x7d, 0xfc, 0xeb, 0xc3, 0x25, 0xfc, 0xf2, 0xf1, 0xed, 0x6f, 0xf3, 0x69, 0xe9, 0x96, 0x72, 0xde,
+    0x99, 0x96, 0x9c, 0xe5, 0xf3, 0x0e, 0xc0, 0xd4, 0x09, 0x27, 0xf9, 0xfc, 0x8d, 0x2a, 0x84, 0x12,
+    0x6e, 0x03, 0x6f, 0x85, 0x31, 0xda, 0xc0, 0x2b, 0xad, 0x9c, 0xd1, 0x52, 0x72, 0x33, 0x1d, 0x04,
+    0x0d, 0xd2, 0x5d, 0x72, 0xc7, 0x40, 0xb1, 0x25, 0x9f, 0x45, 0x2b, 0xc1, 0xd7, 0x95, 0x36, 0x2e,
+    0x82, 0x0c, 0x55, 0xb9, 0x72, 0xb3, 0x68, 0x2d, 0x72, 0x57, 0xce, 0x72, 0xbe, 0x12, 0x19, 0xef,
+    0xfb, 0x8f, 0x1e, 0x90, 0x53, 0xc1, 0x64, 0xdf, 0x66, 0x4c, 0xf2, 0xd9, 0x69, 0xe4, 0xdd, 0x48,
+    0xa1, 0x6e, 0xc0, 0x70, 0x39, 0x8b, 0x04, 0x1a, 0x47, 0x50, 0x1a, 0x5e, 0xcc, 0xa2, 0x9c, 0x39,
+    0x36, 0xee, 0x05, 0x0d, 0xeb, 0x36, 0x01, 0x12, 0x80, 0xf8, 0xc2, 0x5d, 0x81, 0x20, 0xfd, 0x82,
+    0x2d, 0x85, 0xdc, 0x8c, 0xe1, 0x85, 0x41, 0x97, 0x13, 0xc8, 0x85, 0xad, 0x24, 0xc3, 0x6f, 0xa1,
+    0xd0, 0x23, 0xef, 0xa7, 0x52, 0x67, 0x37, 0x13, 0x70, 0xfc, 0xd6, 0xf5, 0x99, 0x14, 0x0b, 0x35,
+    0x86, 0x0c, 0x89, 0x71, 0x33, 0xd9, 0x06, 0x4f, 0xa3, 0xc6, 0x8f, 0x15, 0xff, 0xf0, 0x31, 0x9c,
+    0x25, 0x43, 0xc3, 0x97, 0xcd, 0x5e, 0xf5, 0xfd, 0xad, 0x54, 0xe7, 0x1b, 0xb8, 0x5b, 0xb2, 0xdb,
+    0x10, 0xd3, 0x18, 0x9e, 0x0d, 0x87, 0xd5, 0xed, 0x04, 0x96, 0xcc, 0x2c, 0x84, 0x1a, 0xe3, 0x1a,
+    0x58, 0xed, 0xf4, 0x04, 0x2a, 0x96, 0xe7, 0x42, 0x2d, 0xfa, 0xa9, 0x76, 0x4e, 0x2f, 0xc7, 0x30,
+    0xba, 0x40, 0xb5, 0xe0, 0x23, 0xb1, 0x6b, 0xe1, 0xb2, 0x12, 0xee, 0x2a, 0x6d, 0x31, 0x21, 0x1a,
+    0xa9, 0x61, 0xfc, 0xcc, 0x89, 0x15, 0xff, 0x6e, 0x1c, 0x0d, 0xda, 0xe9, 0xc8, 0xa3, 0x95, 0x5c,
+    0x2c, 0x4a, 0x87, 0xe0, 0xcf, 0xab, 0xdb, 0x2d, 0x1c, 0x39, 0x15, 0xaa, 0xaa, 0x1d, 0xdc, 0xb5,
+    0x6e, 0x94, 0x56, 0x7c, 0x07, 0x2b, 0x45, 0xce, 0xcd, 0x21, 0x2c, 0x4b, 0xad, 0x96, 0xb5, 0x43,
+    0x58, 0xa7, 0xab, 0x31, 0x0c, 0x27, 0x20, 0x79, 0xe1, 0xfc, 0xc2, 0x04, 0x04, 0x5c, 0xed, 0x22,
+    0xa0, 0x25, 0xcb, 0x6e, 0x16, 0x46, 0xd7, 0x2a, 0xef, 0x67, 0x5a, 0x6a, 0x33, 0x86, 0x27, 0x59,
+    0x96, 0x91, 0x8a, 0x41, 0xcf, 0x7d, 0xc3, 0x72, 0x51, 0x5b, 0xa4, 0x85, 0xac, 0x0e, 0x21, 0xc7,
+    0x29, 0x2f, 0xb4, 0xe1, 0xdf, 0x46, 0x6e, 0x2a, 0x66, 0x0c, 0x51, 0xb4, 0x0f, 0xec, 0x62, 0x44,
+    0x61, 0x36, 0x41, 0x87, 0x8f, 0xc0, 0xec, 0x39, 0x2d, 0x77, 0x8c, 0xc2, 0xc7, 0x43, 0x4e, 0x45,
+    0x51, 0x4c, 0xa0, 0xbf, 0xe6, 0xe9, 0x8d, 0x70, 0x7d, 0x67, 0x98, 0xda, 0xa1, 0x26, 0xe7, 0x16,
+    0x43, 0xbd, 0x2f, 0xb8, 0xc7, 0xfe, 0x6c, 0xc7, 0xde, 0xa7, 0x72, 0x9c, 0x95, 0x3c, 0xbb, 0xe1,
+    0xf9, 0x49, 0x9b, 0xbe, 0x6f, 0x00, 0xa6, 0x67, 0x43, 0xfc, 0x79, 0xc4, 0xaa, 0xcd, 0xc0, 0x11,
+    0x2b, 0x14, 0x61, 0x14, 0x7e, 0x89, 0xc7, 0xcf, 0xff, 0x8c, 0x29, 0xd2, 0x2e, 0x52, 0x5f, 0xda,
+    0xc7, 0x15, 0x1e, 0xd9, 0x24, 0x12, 0xd3, 0x41, 0xd3, 0x32, 0xd3, 0x41, 0xe8, 0xec, 0x29, 0x95,
+    0xad, 0xef, 0xa5, 0x72, 0xf4, 0x68, 0x77, 0xe3, 0x36, 0x69, 0xe5, 0x62, 0x05, 0x22, 0x9f, 0x45,
+    0xbc, 0x28, 0x78, 0xe6, 0x6c, 0x34, 0x9f, 0x0e, 0x50, 0x14, 0x1c, 0x9c, 0xcf, 0x5f, 0x61, 0xd4,
+    0x35, 0x29, 0x9f, 0xcf, 0xa7, 0xa1, 0xdc, 0xdc, 0xa6, 0xc2, 0x29, 0xe0, 0xb3, 0x11, 0x79, 0xc3,
+    0xcc, 0xab, 0x44, 0xb0, 0x62, 0xb2, 0xc6, 0x9d, 0x27, 0x3f, 0x15, 0x94, 0xa0, 0x08, 0xb4, 0xf2,
+    0x06, 0xb3, 0xc8, 0x72, 0x95, 0xc7, 0xa7, 0x3d, 0x6c, 0x13, 0x63, 0xf9, 0x1b, 0xe5, 0x62, 0x57,
+    0x0a, 0x9b, 0x78, 0xf5, 0xc4, 0xd6, 0xa9, 0x75, 0x06, 0x9b, 0x27, 0x3e, 0xed, 0xf6, 0xe0, 0xf4,
+    0x59, 0xb7, 0x1b, 0xed, 0xa0, 0xaf, 0x2a, 0xce, 0xf3, 0x87, 0xc8, 0x98, 0x83, 0x05, 0x0f, 0xc8,
+    0x96, 0x34, 0x22, 0x58, 0x0a, 0x35, 0x8b, 0x10, 0x10, 0x3b, 0x75, 0x16, 0x9d, 0x11, 0x74, 0x43,
+    0xe5, 0xf4, 0x21, 0x8d, 0x51, 0x0f, 0x4e, 0xf6, 0xf0, 0xf7, 0xc0, 0x40, 0x17, 0x40, 0x9b, 0x10,
+    0x72, 0xf1, 0x28, 0x76, 0x50, 0xb9, 0xfa, 0xff, 0x0c, 0x9e, 0x7f, 0x87, 0xc1, 0x4b, 0xdf, 0x85,
+    0x8a, 0x5b, 0xfb, 0x28, 0x6e, 0xda, 0xaa, 0xdd, 0x83, 0x1d, 0x5d, 0x5c, 0xb4, 0xb0, 0x7e, 0x7d,
+    0x0c, 0x7b, 0xf6, 0x00, 0x76, 0x6a, 0x33, 0x23, 0x2a, 0x37, 0xef, 0xac, 0x98, 0x01, 0x8b, 0x93,
+    0x87, 0x3b, 0x98, 0x81, 0xe2, 0x6b, 0xf8, 0xc4, 0xd3, 0x2b, 0xff, 0x1d, 0x47, 0x6b, 0x3b, 0x1e,
+    0x0c, 0x22, 0x38, 0x01, 0x1c, 0x4d, 0x8c, 0xfa, 0x28, 0x29, 0xb5, 0x75, 0xf8, 0x1d, 0x0d, 0xd6,
+    0x36, 0xea, 0x4e, 0x3a, 0xc1, 0x30, 0x49, 0x85, 0x62, 0x66, 0xf3, 0x11, 0xd9, 0xa2, 0x8f, 0x88,
+    0x19, 0xc3, 0x36, 0x69, 0x8d, 0x29, 0x32, 0xd1, 0xc4, 0xfb, 0xaf, 0x90, 0x03, 0x9e, 0x32, 0x6e,
+    0xde, 0x6d, 0x83, 0xa4, 0x90, 0xb5, 0x2d, 0x3f, 0x8a, 0x25, 0xb6, 0x19, 0xa2, 0xd6, 0x52, 0x4e,
+    0x3a, 0x9d, 0xc1, 0x00, 0xb2, 0x92, 0x62, 0xb5, 0xc0, 0xb0, 0x83, 0x32, 0xaa, 0xd4, 0xcc, 0xe1,
+    0xc1, 0x30, 0x95, 0x03, 0x86, 0x81, 0xf9, 0xd0, 0x0b, 0xee, 0x4a, 0xb4, 0x61, 0x50, 0x20, 0x53,
+    0x87, 0xf6, 0xa8, 0x8b, 0x7b, 0x38, 0x5a, 0xf2, 0x1e, 0xc6, 0x2c, 0x37, 0x78, 0x84, 0x9c, 0x3c,
+    0x61, 0x24, 0x1c, 0xa9, 0xfa, 0x78, 0xe9, 0x64, 0x39, 0xcb, 0xf0, 0x5e, 0xb2, 0x1a, 0x72, 0xc3,
+    0x16, 0x0b, 0x22, 0x83, 0x76, 0xa1, 0xcf, 0x73, 0xcd, 0xad, 0x7a, 0xea, 0x90, 0x93, 0xd6, 0x39,
+    0xd9, 0x63, 0x6a, 0xa9, 0x5f, 0x3a, 0x45, 0xad, 0x32, 0x8a, 0x1a, 0x7c, 0x0e, 0xe9, 0x30, 0x7a,
+    0xc1, 0x61, 0x17, 0xee, 0xf0, 0xdc, 0x9a, 0xa8, 0x3e, 0xd3, 0xc6, 0x17, 0x0c, 0xc3, 0x6f, 0x4d,
+    0x70, 0x43, 0x14, 0x10, 0x1f, 0x06, 0x38, 0x0b, 0x21, 0xa2, 0xd5, 0x71, 0xdc, 0x96, 0x3b, 0x5a,
+    0xea, 0xda, 0x05, 0xf5, 0x1e, 0x9c, 0x0f, 0xb1, 0xe7, 0xb7, 0x9d, 0x6d, 0x67, 0x8f, 0xed, 0x77,
+    0xe2, 0x80, 0xf8, 0x8d, 0xac, 0x01, 0x50, 0x3a, 0x89, 0x82, 0x45, 0xd9, 0xfb, 0xf4, 0x2b, 0xa6,
+    0x2c, 0xb9, 0xe1, 0x1b, 0x1b, 0x37, 0xf4, 0xba, 0x3b, 0x46, 0x5e, 0x27, 0x91, 0x5c, 0x2d, 0x5c,
+    0xe9, 0x39, 0x0d, 0x89, 0x90, 0xe1, 0xae, 0x36, 0x8a, 0x40, 0x83, 0x56, 0x73, 0xa2, 0x06, 0xa7,
+    0xc9, 0xe6, 0xca, 0xe1, 0xb4, 0x81, 0x1f, 0x50, 0xb5, 0xad, 0x89, 0xe4, 0xfd, 0x87, 0xcb, 0x77,
+    0xff, 0x21, 0x90, 0xd1, 0x90, 0x22, 0x39, 0x74, 0x4e, 0x34, 0xe9, 0xf5, 0xd0, 0x54, 0xd9, 0x6b,
+    0xbc, 0xf6, 0xff, 0xc0, 0xcf, 0x98, 0x3e, 0x5e, 0x50, 0xc5, 0xbc, 0xf4, 0x15, 0x73, 0x4c, 0xf3,
+    0x47, 0xb8, 0xe8, 0xfa, 0x00, 0x82, 0x14, 0x07, 0xe1, 0x25, 0x9e, 0x63, 0xdc, 0x26, 0xa7, 0x39,
+    0x14, 0x11, 0xd2, 0x03, 0x1e, 0x20, 0x41, 0x36, 0xbf, 0x0b, 0xe5, 0x9e, 0xc7, 0x82, 0xec, 0xa9,
+    0xf2, 0x51, 0xc9, 0x7b, 0x39, 0x56, 0x38, 0x1b, 0x05, 0x0d, 0xac, 0x67, 0x9a, 0x4f, 0x87, 0xa7,
+    0xd9, 0xc3, 0x69, 0x5b, 0x07, 0x9b, 0xad, 0xff, 0x7d, 0x5c, 0xc1, 0xd0, 0x74, 0x4c, 0xe2, 0x0b,
+    0xc3, 0xfb, 0x0c, 0xf5, 0x8e, 0xba, 0x5b, 0x5f, 0xc8, 0x78, 0x17, 0x43, 0x73, 0x4f, 0x57, 0x98,
+    0xa2, 0x30, 0x2f, 0x7a, 0xbe, 0xb8, 0xe8, 0x21, 0x65, 0xb1, 0xba, 0x97, 0x1c, 0x0a, 0xa3, 0x97,
+    0xdf, 0x2c, 0x38, 0x7c, 0x52, 0x5c, 0x79, 0x6b, 0x6e, 0x63, 0xaf, 0x1f, 0x02, 0xa4, 0x1c, 0xfa,
+    0x87, 0xd1, 0x8c, 0xee, 0x50, 0x2a, 0x08, 0x9c, 0xea, 0x31, 0x49, 0x45, 0x8e, 0xb2, 0xd3, 0x09,
+    0xfd, 0x9d, 0x06, 0x84, 0x26, 0x85, 0x24, 0x3a, 0x39, 0xd9, 0xe5, 0xc7, 0x1b, 0x9f, 0xa0, 0x35,
+    0xcd, 0x1c, 0x6a, 0x6c, 0xaf, 0xfa, 0x59, 0xe4, 0x5f, 0xa8, 0xa9, 0xc3, 0xe8, 0x91, 0x2c, 0xe5,
+    0x12, 0x32, 0xc9, 0xac, 0x9d, 0x5d, 0x47, 0x21, 0x88, 0xeb, 0xe8, 0x68, 0x24, 0x5d, 0x47, 0xfe,
+    0xd6, 0x4b, 0xf5, 0xed, 0x35, 0x4d, 0x9a, 0xd0, 0xb5, 0x28, 0xc5, 0xfe, 0x5c, 0x48, 0xfe, 0xaa,
+    0xd9, 0xf3, 0x93, 0xbe, 0x7b, 0xed, 0x27, 0xd7, 0x75, 0x44, 0x68, 0xc8, 0x0e, 0x61, 0xc8, 0x99,
+    0xad, 0x98, 0xda, 0x63, 0xf8, 0x3e, 0x24, 0xf1, 0x80, 0xe4, 0xf8, 0xc7, 0x73, 0x98, 0xfb, 0x10,
+    0xa9, 0x76, 0x72, 0x9d, 0xd5, 0x4b, 0x1c, 0x00, 0x09, 0xb6, 0xff, 0xa5, 0xe4, 0xb4, 0x7c, 0xb9,
+    0x79, 0x93, 0xc7, 0xed, 0xb5, 0xd5, 0x4d, 0x84, 0x52, 0xdc, 0xd0, 0x53, 0x17, 0xf3, 0x40, 0x51,
+    0x4e, 0x8e, 0x9a, 0xe8, 0x1e, 0x31, 0x1e, 0x7c, 0x84, 0xac, 0xf8, 0x33, 0x1c, 0xf6, 0xa0, 0x11,
+    0x26, 0xcd, 0x85, 0x0e, 0x3f, 0xc3, 0xc9, 0x4e, 0x84, 0xbc, 0xf1, 0x55, 0xd4, 0x3d, 0xf6, 0x69,
+    0x4b, 0xbd, 0xf6, 0x1d, 0x12, 0x5b, 0xfa, 0xbd, 0x3f, 0x21, 0x44, 0xf0, 0xcd, 0xd8, 0xb2, 0xfe,
+    0xbb, 0xe6, 0x66, 0x73, 0xc5, 0x69, 0x9a, 0x69, 0xf3, 0x42, 0xca, 0x38, 0x7a, 0xd2, 0x10, 0x0f,
+    0x6f, 0x88, 0xa8, 0x7b, 0x7c, 0x96, 0x68, 0x8b, 0x4f, 0x30, 0x81, 0x27, 0xe9, 0x5d, 0xed, 0x4f,
+    0x72, 0x7f, 0x90, 0x7e, 0xe3, 0xb3, 0xf8, 0xd2, 0xb2, 0x9d, 0x41, 0x7c, 0xd2, 0x0a, 0xa9, 0x1a,
+    0xb0, 0x2b, 0x89, 0x56, 0x12, 0x90, 0xba, 0xbb, 0x54, 0x62, 0x6d, 0x4a, 0xce, 0x56, 0x1c, 0xc7,
+    0x5f, 0x16, 0x9e, 0x03, 0xc0, 0x24, 0x55, 0xeb, 0xba, 0x14, 0x92, 0x83, 0x70, 0x4f, 0x2d, 0xa4,
+    0x9c, 0x4a, 0xdd, 0x0f, 0x4a, 0x9e, 0x37, 0x41, 0x79, 0xa2, 0x14, 0xd5, 0x1d, 0x84, 0x2b, 0x1f,
+    0x9f, 0x71, 0x4f, 0xe8, 0x4c, 0x03, 0x4a, 0x90, 0xe1, 0x80, 0xa5, 0x2b, 0x71, 0xdc, 0x08, 0xfd,
+    0x47, 0x0f, 0x0e, 0x2e, 0xcb, 0xf1, 0x11, 0xa9, 0xab, 0xb0, 0xbf, 0xbf, 0xd4, 0x76, 0xdb, 0x7b,
+    0x09, 0x6c, 0x8f, 0x52, 0x43, 0xe5, 0x8a, 0x54, 0x1a, 0x36, 0x6d, 0xd7, 0xef, 0xf8, 0x1d, 0x26,
+    0xfd, 0x5e, 0xa9, 0x90, 0x65, 0x33, 0x03, 0x68, 0xcc, 0x05, 0x75, 0x1a, 0x6d, 0xad, 0x01, 0xcb,
+    0xe8, 0x5d, 0x7e, 0xd9, 0x96, 0x46, 0x70, 0x19, 0x6e, 0x4c, 0x74, 0x1c, 0x20, 0x3f, 0x93, 0x9f,
+    0x2f, 0x61, 0xa2, 0x6d, 0x9b, 0x5e, 0xa7, 0x06, 0xae, 0xd8, 0x82, 0x92, 0x67, 0xb9, 0x2c, 0x00,
+    0x9f, 0x10, 0x19, 0x4e, 0x29, 0x0a, 0x6d, 0x5d, 0x32, 0x87, 0x62, 0x5f, 0x2b, 0xa1, 0xe7, 0x6d,
+    0x68, 0xfa, 0x81, 0x0f, 0xd4, 0xdf, 0x6c, 0x68, 0xae, 0xc8, 0x4d, 0x3b, 0x0c, 0x9a, 0xdb, 0x78,
+    0x8d, 0x72, 0xbe, 0xc2, 0xe1, 0x81, 0xf6, 0xcd, 0xbd, 0xd8, 0xdb, 0x29, 0x21, 0x84, 0x47, 0xc4,
+    0xbc, 0x30, 0xa5, 0xe9, 0x4a, 0xec, 0x14, 0x1c, 0xfb, 0x34, 0x8e, 0x82, 0x63, 0x6c, 0x08, 0x72,
+    0x7b, 0x30, 0x28, 0x0d, 0xb7, 0x95, 0x56, 0x96, 0xef, 0x67, 0x3e, 0xec, 0x44, 0xc9, 0x57, 0xab,
+    0x55, 0x4c, 0x17, 0xcf, 0x03, 0xab, 0x83, 0xca, 0x3e, 0x1c, 0x49, 0x87, 0x87, 0x68, 0x7d, 0x56,
+    0xef, 0x37, 0x03, 0xb6, 0xca, 0xfe, 0x79, 0xa0, 0x15, 0xc6, 0x6d, 0x89, 0xef, 0x0c, 0xf6, 0xbe,
+    0x31, 0xb6, 0xb6, 0x05, 0x5b, 0xeb, 0x5f, 0xaf, 0xde, 0xbf, 0x4b, 0xfc, 0x53, 0x31, 0xec, 0x27,
+    0xf4, 0xef, 0x21, 0x5d, 0x01, 0x58, 0x07, 0x38, 0x1d, 0x9a, 0x37, 0xcb, 0xb4, 0x3c, 0x9b, 0x7f,
+    0x32, 0xc2, 0xe1, 0xbf, 0x13, 0x90, 0x6e, 0xf0, 0x2e, 0x59, 0x61, 0xc5, 0x5f, 0xca, 0xdc, 0x88,
+    0x1c, 0x41, 0x46, 0xc3, 0xd1, 0x39, 0x69, 0xa0, 0x41, 0x78, 0x0d, 0xe3, 0x5c, 0xf3, 0xff, 0xfd,
+    0xfe, 0x0b, 0x12, 0x3a, 0x23, 0x91, 0x14, 0x0f, 0x00, 0x00,
+};
+
+#endif
@@ -3,16 +3,118 @@
 
 #include <NeoPixelBus.h>
 #include <NeoPixelAnimator.h>
+#include <StripOutput.h>
+#include <CommandQueue.h>
+#include <TimeHistogram.h>
+#include <StreamReceiver.h>
 
 // Function to Initalise the NeoPixel Strip, found in Setup function in Examples
 void initStrip();
 void SetRandomSeed();
+// Seed the effects with a fixed value instead, so a run can be replayed
+void SetRandomSeed(uint32_t seed);
 
-// Function to select which Animation should be played
+// Number of pixels over every strip in the layout
+uint16_t getPixelCount();
+
+// How the pixels are split over the data pins, LED_PIXEL_COUNT pixels on
+// pin 5 until one is saved. A saved layout is used from the next boot.
+StripLayout getStripLayout();
+// Web server task only. Passes a new layout to the render task as a
+// command, returns false if it isn't valid, the queue is full or another
+// is still on its way to being saved
+bool setStripLayout(const StripLayout& layout);
+// Saves the layout the render task took from setStripLayout() to NVS,
+// returns true once one has been saved and the mirror should restart.
+// Call it from loop(), never the render task, as a flash write stalls the CPU.
+bool saveRequestedLayout();
+
+// Gamma, brightness and white balance applied to every effect on its way
+// to the strip, takes effect from the next frame
+OutputSettings getOutputSettings();
+void setOutputSettings(const OutputSettings& settings);
+
+// Set a run of pixels to one colour, much faster than SetPixelColor on each
+void fillPixels(const FrameColor& color, uint16_t first, uint16_t count);
+
+// Fade every pixel towards black, call it regularly to leave trails
+// behind anything that moves
+void darkenPixels(uint8_t darkenBy);
+
+// The frame the effects draw into, before the output stage
+const FrameBuffer& getFrame();
+
+// Function to select which Animation should be played, draws one frame.
+// While a network stream is live its frames are shown instead, and the
+// selected animation cross fades back in once the stream stops.
 void animationSelector(int selectedAnimation);
 
+// Where streamed frames arrive, packets are passed to its Receive()
+StreamReceiver& getStreamReceiver();
+
+// Other tasks don't call the setters here while the render task is running,
+// they post a command instead. The render task applies everything posted
+// at the start of its next frame, so a change never lands part way through
+// drawing or sending one and the sender never waits on rendering.
+// Only one task may post, the AsyncTCP task the web server runs on.
+// Returns false if the queue is full.
+bool postCommand(CommandType type, uint32_t value);
+
+// Render task only, applies every command posted since the last call in
+// the order they were posted. Of a run of the same type only the last is
+// applied, so a slider dragged faster than the frame rate costs one change
+// a frame.
+void applyCommands();
+
+// Goes up each time applyCommands() changes something, so other tasks can
+// tell when to send the state out again
+uint32_t getStateVersion();
+
+// The animation the last applied Command_SetEffect selected
+int getSelectedEffect();
+
+// The effect and everything set from the page are saved to NVS once they
+// have stopped changing for a few seconds, and initStrip() puts them back.
+// Only saves what differs from the last save. Call it from loop(), never
+// the render task, as a flash write stalls the CPU.
+void saveStateWhenQuiet();
+
+// How fast every effect runs, percent of normal speed, 0 pauses them
+uint16_t getEffectSpeed();
+void setEffectSpeed(uint16_t percent);
+
+// How fast one effect runs on top of that, percent of its normal speed,
+// so each can be set to look right on its own. A change to the running
+// effect takes effect from the next frame without setting it up again.
+uint16_t getEffectSpeed(int animation);
+void setEffectSpeed(int animation, uint16_t percent);
+
+// How long the new effect takes to fade in over the last one, in ms,
+// 0 switches straight over
+uint16_t getTransitionTime();
+void setTransitionTime(uint16_t duration);
+
+// Effects that can be selected, animation 0 is off
+int getEffectCount();
+const char* getEffectName(int animation);
+
+// Send the frame to the strip if any pixel changed since the last one,
+// returns true if it was sent
+bool showFrame();
+
+struct FrameCounters {
+    uint32_t sent;    // frames sent to the strip
+    uint32_t skipped; // frames that matched what the strip already shows
+};
+
+FrameCounters getFrameCounters();
+
+// How long sending each frame to the strip took, in us
+const TimeHistogram& getShowTimes();
+
 // Cylon Eye Colour Picker
 void changeCylonColour(RgbColor eyeColour);
+RgbColor getCylonColour();
 
 /**/
 
@@ -0,0 +1,117 @@
+#ifndef OUTPUT_STAGE_H
+#define OUTPUT_STAGE_H
+
+#include <NeoPixelBus.h>
+#include <FrameBuffer.h>
+
+// What the output stage does to every colour on its way to the strip
+struct OutputSettings {
+    float gamma;         // 1.0 leaves the effects' values linear
+    uint8_t brightness;  // 255 is full brightness
+    RgbColor whiteBalance; // scale of each channel at full brightness
+    bool dither;         // spread the fraction of a step over frames
+};
+
+// Gamma, brightness and white balance for every effect, applied once per
+// frame as the frame is copied to the strip. All three are folded into one
+// lookup per channel, rebuilt only when the settings change, so the cost
+// is a table read per channel whatever the settings are. The gamma curve
+// is kept apart from the tables, so only a new gamma recomputes it.
+//
+// The result keeps 8 bits of fraction. With dithering on, the fraction
+// left over from each frame is carried into the next, so over a few
+// frames a channel averages out to its 16 bit value rather than being
+// rounded to the same 8 bit step every time. That is what keeps dim
+// colours and the ends of fades from stepping.
+//
+// For an RGBW strip the part of a colour all three LEDs share, after the
+// curve, is sent to the white LED instead, so whites and pastels come
+// from the white LED and everything else looks the same as on RGB.
+class OutputStage {
+public:
+    OutputStage();
+
+    // Sets aside what is carried between frames for count pixels, once at boot
+    void Begin(uint16_t count);
+
+    void SetSettings(const OutputSettings& settings);
+
+    const OutputSettings& Settings() const {
+        return _settings;
+    }
+
+    // While set every value is rounded even with dithering on, for a frame
+    // that has stood still long enough that moving it on only flickers
+    void SetDitherPaused(bool paused) {
+        _ditherPaused = paused;
+    }
+
+    bool DitherPaused() const {
+        return _ditherPaused;
+    }
+
+    // While set the gamma curve is left out and only brightness and white
+    // balance apply, for frames the sender has already corrected
+    void SetGammaBypass(bool bypass);
+
+    // While set, every frame applied is first blended from this one by a
+    // Q16 weight, 0 shows only from. from must be normalised and the same
+    // size as the frames applied, NULL ends the transition.
+    void SetTransition(const FrameBuffer* from, uint32_t weight) {
+        _from = from;
+        _weight = weight;
+    }
+
+    // Writes strip pixels first to first + count - 1 of the frame into
+    // wire, Strip::BytesPerPixel bytes each, returns false if wire already
+    // held exactly those values
+    bool Apply(const FrameBuffer& frame, uint8_t* wire, uint16_t first, uint16_t count);
+
+    // 8.8 fixed point output for one channel value, index is the channel
+    // in the pixel
+    uint16_t Correct(uint8_t index, uint16_t value) const {
+        // rescale 0-65535 to 0-65280 so an 8 bit colour, which is its value
+        // times 257, lands exactly on a table entry with no fraction
+        const uint16_t* table = _tables[index];
+        uint16_t scaled = value - (value >> 8);
+        uint16_t step = scaled >> 8;
+        uint16_t fraction = scaled & 0xff;
+        return table[step] + ((table[step + 1] - table[step]) * fraction >> 8);
+    }
+
+private:
+    void buildTables();
+
+    // count is in pixels from here on, as the frame and wire strides differ
+    bool applyRun(const uint16_t* channels, const uint16_t* from, uint8_t* wire, uint8_t* carry, uint16_t count) const;
+
+    // fading and dithering are template parameters so the plain path has
+    // no blend or test in its loop
+    template <bool Fading, bool Dither> bool apply(const uint16_t* channels, const uint16_t* from,
+        uint8_t* wire, uint8_t* carry, uint16_t count) const;
+
+    template <bool Fading> uint16_t input(const uint16_t* channels, const uint16_t* from, size_t index) const {
+        if (!Fading) {
+            return channels[index];
+        }
+        return BlendChannel(from[index], channels[index], _weight);
+    }
+
+    OutputSettings _settings;
+    // the gamma curve alone at full scale, 8.8 fixed point, and the gamma
+    // it was built for
+    uint16_t _curve[256];
+    float _curveGamma;
+    bool _gammaBypass;
+    bool _ditherPaused;
+    // the curve at each 8 bit value, the last entry repeated so the top
+    // step has an end to interpolate to
+    uint16_t _tables[FrameBuffer::ChannelsPerPixel][257];
+    // fraction carried to the next frame, per byte sent in strip order
+    uint8_t* _carry;
+    uint16_t _count;
+    const FrameBuffer* _from;
+    uint32_t _weight;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef RENDER_TASK_H
+#define RENDER_TASK_H
+
+#include <Arduino.h>
+#include <TimeHistogram.h>
+
+struct RenderStats {
+    uint16_t targetFps;
+    uint32_t frames;  // frames rendered
+    uint32_t shows;   // frames sent to the strip
+    uint32_t skipped; // frames not sent because nothing changed
+    uint32_t dropped; // frames missed because rendering ran late
+};
+
+// Start the FreeRTOS task that renders the selected animation at a fixed rate
+void startRenderTask(uint16_t targetFps);
+
+// Change the frame rate of the running render task
+void setRenderFps(uint16_t targetFps);
+
+// Microseconds until the render task starts its next frame, so work that
+// would hold it up, like writing the flash, can fit in between frames
+uint32_t getTimeUntilNextFrame();
+
+RenderStats getRenderStats();
+
+// How long each frame took to draw and send, in us
+const TimeHistogram& getFrameTimes();
+
+// When the first frame had been sent to the strip, in us since boot, or 0
+// before it has
+uint32_t getFirstFrameTime();
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SAVED_STATE_H
+#define SAVED_STATE_H
+
+#include <Arduino.h>
+
+// Effects there is room for a speed of, more than there are so adding one
+// doesn't change the record
+const uint8_t SavedEffectCount = 8;
+
+// What is put back after a restart, the effect and everything set from
+// the page. Colours are 0xRRGGBB.
+struct SavedState {
+    uint8_t version;
+    uint8_t effect;
+    uint8_t brightness;
+    uint8_t dither;
+    uint32_t colour;
+    uint32_t whiteBalance;
+    uint16_t speed;
+    uint16_t transition;
+    float gamma;
+    uint16_t effectSpeeds[SavedEffectCount]; // percent, by animation number
+    uint32_t crc; // of everything before it
+};
+
+// CRC-32 as zlib and Ethernet have it
+uint32_t crc32(const uint8_t* data, size_t length);
+
+// Saved state from NVS, returns false and leaves state alone if there
+// isn't one, it's from another version or it doesn't match its CRC
+bool loadSavedState(SavedState& state);
+
+// Writes state to NVS with its CRC. It takes the flash for milliseconds,
+// so never call it from the render task.
+bool saveSavedState(const SavedState& state);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef STREAM_INPUT_H
+#define STREAM_INPUT_H
+
+#include <Arduino.h>
+
+// Listen for E1.31 and Art-Net DMX on their usual ports, call once WiFi is
+// up and the strip is set up. Streamed frames are shown in place of the
+// selected effect until the sender stops.
+void startStreamInput();
+
+#endif
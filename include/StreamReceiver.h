@@ -0,0 +1,136 @@
+#ifndef STREAM_RECEIVER_H
+#define STREAM_RECEIVER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <FrameBuffer.h>
+#include <CommandQueue.h>
+#include <StripOutput.h>
+
+// UDP ports the show controller sends to
+const uint16_t E131Port = 5568;
+const uint16_t ArtNetPort = 6454;
+
+// A DMX universe is 512 channels, 170 whole RGB pixels
+const uint16_t PixelsPerUniverse = 170;
+const uint8_t MaxStreamUniverses = (MaxPixelCount + PixelsPerUniverse - 1) / PixelsPerUniverse;
+
+struct StreamStats {
+    uint32_t packets;    // packets for our universes
+    uint32_t lost;       // packets missing from the sequence numbers
+    uint32_t outOfOrder; // packets arriving after a later one, ignored
+    uint32_t incomplete; // frames abandoned with a universe missing
+    uint32_t overruns;   // packets ignored with every frame slot full
+    uint32_t frames;     // whole frames received
+    uint32_t skipped;    // frames replaced by a newer one before being shown
+    uint32_t shown;      // frames shown
+};
+
+// Frames of pixels streamed over the network, E1.31 (sACN) or Art-Net DMX,
+// one universe of 170 RGB pixels after another from firstUniverse.
+//
+// Receive() runs on the network task and reads each packet where the UDP
+// stack left it, widening every DMX value to 16 bits as it is written into
+// the frame slot being filled. Once every universe of a frame is in, the
+// slot is queued for the render task, which swaps it in as the frame to
+// show rather than copying it again. The values are taken as already
+// corrected for the strip, so the output stage leaves the gamma curve out
+// while a stream is showing.
+//
+// Frames are shown on an even schedule rather than as they arrive. The
+// interval is the average time between frames arriving, and the schedule
+// runs a latency behind the first frame, so a frame can arrive up to that
+// late and still go out when it would have on a perfect network. A frame
+// that misses its place is shown as soon as it arrives, and the schedule
+// starts again from a new frame if it drifts from the sender's clock.
+class StreamReceiver {
+public:
+    // frame slots besides the one being shown, one being filled and the
+    // rest waiting out the latency
+    static const uint8_t SlotCount = 3;
+    // E1.31 treats a source as gone after 2.5 s without data
+    static const uint32_t DefaultTimeout = 2500; // ms
+    static const uint16_t DefaultLatency = 30; // ms
+
+    StreamReceiver();
+
+    // Sets aside the frame slots for count pixels, once at boot
+    void Begin(uint16_t count, uint16_t firstUniverse = 1);
+
+    // Network task only. Takes one UDP packet, returns false if it isn't
+    // a DMX packet for one of our universes
+    bool Receive(const uint8_t* packet, size_t length, uint32_t nowMillis);
+
+    // True while packets are arriving, false before the first, once they
+    // stop for the timeout or as soon as the sender ends the stream
+    bool IsActive(uint32_t nowMillis) const;
+
+    // Render task only. Swaps the newest frame that has waited out the
+    // latency in as frame, which must be the pixel count given to Begin().
+    // Returns false, leaving frame alone, if none is due.
+    bool Exchange(FrameBuffer& frame, uint32_t nowMillis);
+
+    // Render task only. Drops any frames still waiting once the stream
+    // has stopped, so they aren't shown when it starts again
+    void Flush();
+
+    void SetLatency(uint16_t latency) {
+        _latency = latency;
+    }
+
+    void SetTimeout(uint32_t timeout) {
+        _timeout = timeout;
+    }
+
+    StreamStats Stats() const {
+        return _stats;
+    }
+
+private:
+    struct Universe {
+        const uint8_t* data; // channel 1 onwards
+        uint16_t length;     // channels in data
+        uint16_t number;
+        uint8_t sequence;
+        bool numbered;       // false if the sender doesn't number its packets
+        bool terminated;     // the sender is ending the stream
+    };
+
+    static bool parseE131(const uint8_t* packet, size_t length, Universe& universe);
+    static bool parseArtNet(const uint8_t* packet, size_t length, Universe& universe);
+
+    void schedule(uint8_t slot);
+    void release(uint8_t slot);
+
+    uint16_t* _slots[SlotCount]; // channels of a frame each
+    uint16_t _count;
+    uint16_t _firstUniverse;
+    uint8_t _universeCount;
+    uint16_t _latency;
+    uint32_t _timeout;
+
+    // network task side
+    int8_t _filling;       // slot being written, -1 with none free
+    uint32_t _lastFrame;   // when the last whole frame arrived
+    uint32_t _interval;    // average ms between whole frames, 1/16ths
+    uint16_t _received;    // universes of it written so far
+    uint16_t _sequenced;   // universes a sequence number has been seen for
+    uint8_t _sequences[MaxStreamUniverses];
+    StreamStats _stats;
+
+    // slots handed between the two tasks, each ring has one task on each end
+    CommandQueue<uint8_t, 4> _ready;
+    CommandQueue<uint8_t, 4> _free;
+    uint32_t _arrived[SlotCount]; // when each queued slot was completed
+    uint32_t _intervals[SlotCount]; // average ms between frames, 1/16ths, at that point
+    std::atomic<uint32_t> _lastPacket;
+    std::atomic<bool> _started;
+    std::atomic<bool> _terminated;
+
+    // render task side
+    int8_t _next;      // taken from _ready but not due yet
+    uint32_t _nextDue; // when it is due
+    bool _scheduled;   // _nextDue follows on from the frame before
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef STRIP_DESCRIPTOR_H
+#define STRIP_DESCRIPTOR_H
+
+#include <NeoPixelBus.h>
+#include <type_traits>
+
+// Colour orders, where red, green and blue sit in a pixel as the strip
+// takes them. On an RGBW strip the white channel follows them.
+struct GrbOrder {
+    static const uint8_t Red = 1;
+    static const uint8_t Green = 0;
+    static const uint8_t Blue = 2;
+    typedef NeoGrbFeature RgbFeature;
+    typedef NeoGrbwFeature RgbwFeature;
+};
+
+struct RgbOrder {
+    static const uint8_t Red = 0;
+    static const uint8_t Green = 1;
+    static const uint8_t Blue = 2;
+    typedef NeoRgbFeature RgbFeature;
+    typedef NeoRgbwFeature RgbwFeature;
+};
+
+// Everything about the strip that is fixed when the firmware is built.
+// The frame, output stage and effects take their channel positions and
+// sizes from here as constants, so a pixel write is a store to a known
+// offset rather than a lookup, and one source drives any of the strips.
+//
+// White is an RGBW strip like the SK6812, the output stage moves the part
+// of each colour all three LEDs share onto the white one. PixelCount is
+// for a fixed installation, every loop over the strip then has a bound
+// the compiler knows, 0 takes the count from the layout at boot.
+template <typename T_ORDER, bool T_WHITE = false, uint16_t T_PIXEL_COUNT = 0> struct StripDescriptor {
+    typedef T_ORDER Order;
+    typedef typename std::conditional<T_WHITE,
+        typename T_ORDER::RgbwFeature, typename T_ORDER::RgbFeature>::type ColorFeature;
+
+    static const bool HasWhite = T_WHITE;
+    static const uint8_t BytesPerPixel = ColorFeature::PixelSize;
+    // after red, green and blue
+    static const uint8_t White = 3;
+    static const uint16_t PixelCount = T_PIXEL_COUNT;
+
+    static_assert(BytesPerPixel == (T_WHITE ? 4 : 3), "colour feature doesn't match the white channel");
+};
+
+// The strip this firmware drives, chosen with build flags
+//   -D LED_COLOR_ORDER=RgbOrder    GrbOrder, as WS2812 strips take it, if not set
+//   -D LED_RGBW                    strips with a white LED as well
+//   -D LED_FIXED_PIXEL_COUNT=300   a fixed installation, see PixelCount
+#ifndef LED_COLOR_ORDER
+#define LED_COLOR_ORDER GrbOrder
+#endif
+#ifndef LED_FIXED_PIXEL_COUNT
+#define LED_FIXED_PIXEL_COUNT 0
+#endif
+#ifdef LED_RGBW
+typedef StripDescriptor<LED_COLOR_ORDER, true, LED_FIXED_PIXEL_COUNT> Strip;
+#else
+typedef StripDescriptor<LED_COLOR_ORDER, false, LED_FIXED_PIXEL_COUNT> Strip;
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef STRIP_OUTPUT_H
+#define STRIP_OUTPUT_H
+
+#include <NeoPixelBus.h>
+#include <FrameBuffer.h>
+#include <OutputStage.h>
+
+// One RMT channel each, the S2 has four
+const uint8_t MaxStripSegments = 4;
+// Largest total the frame and effect state are allowed to be set up for
+const uint16_t MaxPixelCount = 2400;
+
+// A physical strip on its own data pin
+struct StripSegment {
+    uint8_t pin;
+    uint16_t count;
+};
+
+// How the logical frame is split over the physical strips, segment 0
+// shows the first pixels of the frame, segment 1 the ones after and so on
+struct StripLayout {
+    uint8_t segmentCount;
+    StripSegment segments[MaxStripSegments];
+};
+
+uint16_t getLayoutPixelCount(const StripLayout& layout);
+bool isValidLayout(const StripLayout& layout);
+
+// Layout saved in NVS, returns false and leaves layout alone if there
+// isn't a valid one saved
+bool loadStripLayout(StripLayout& layout);
+bool saveStripLayout(const StripLayout& layout);
+
+// A NeoPixelBus of any method, so each segment can use its own channel
+class StripBus {
+public:
+    virtual ~StripBus() {}
+    virtual void Begin() = 0;
+    virtual uint8_t* Pixels() = 0;
+    virtual void Show() = 0;
+};
+
+template <typename T_METHOD> class NeoStripBus : public StripBus {
+public:
+    NeoStripBus(uint16_t count, uint8_t pin) :
+        _bus(count, pin) {
+    }
+
+    void Begin() override {
+        _bus.Begin();
+    }
+
+    uint8_t* Pixels() override {
+        return _bus.Pixels();
+    }
+
+    void Show() override {
+        _bus.Dirty();
+        _bus.Show();
+    }
+
+private:
+    NeoPixelBus<Strip::ColorFeature, T_METHOD> _bus;
+};
+
+// Sends a frame out over every segment of the layout. The RMT channels
+// clock their data out in the background, so the segments are sent in
+// parallel and a long mirror split in four takes a quarter of the time.
+class StripOutput {
+public:
+    StripOutput();
+
+    // Creates the buses, once at boot, and blanks the strips
+    bool Begin(const StripLayout& layout);
+
+    uint16_t PixelCount() const {
+        return _pixelCount;
+    }
+
+    // Sends the segments whose pixels, after the output stage, changed
+    // since they were last sent, returns false if none had
+    bool Show(const FrameBuffer& frame, OutputStage& stage);
+
+private:
+    StripBus* _buses[MaxStripSegments];
+    uint16_t _first[MaxStripSegments];
+    uint16_t _count[MaxStripSegments];
+    uint8_t _segmentCount;
+    uint16_t _pixelCount;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TIME_HISTOGRAM_H
+#define TIME_HISTOGRAM_H
+
+#include <Arduino.h>
+
+// Counts durations into a fixed set of buckets so percentiles can be read
+// back without keeping the samples. Values under 8 get a bucket each, above
+// that every power of two is split into 8, so a percentile is never more
+// than an eighth over the real value. Recording is a few instructions and
+// the whole thing is under a kilobyte, cheap enough to leave on.
+class TimeHistogram {
+public:
+    // 8 exact buckets, 8 for each power of two up to 2^24, then one more
+    // for anything longer
+    static const uint8_t BucketCount = 177;
+
+    TimeHistogram();
+
+    void Record(uint32_t value);
+    void Reset();
+
+    uint32_t Count() const {
+        return _count;
+    }
+
+    // 0 until something has been recorded
+    uint32_t Min() const {
+        return (_count > 0) ? _min : 0;
+    }
+
+    uint32_t Max() const {
+        return _max;
+    }
+
+    uint32_t Average() const {
+        return (_count > 0) ? (uint32_t)(_sum / _count) : 0;
+    }
+
+    // The value percent of the recordings are at or below, rounded up to
+    // the top of its bucket
+    uint32_t Percentile(uint8_t percent) const;
+
+private:
+    static uint8_t bucketOf(uint32_t value);
+    static uint32_t bucketTop(uint8_t bucket);
+
+    uint32_t _buckets[BucketCount];
+    uint32_t _count;
+    uint32_t _min;
+    uint32_t _max;
+    uint64_t _sum;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include <Arduino.h>
+
+// virtual clock, kept in microseconds so micros() has something to report
+static uint64_t hostMicros = 0;
+
+// xorshift32 backing random(), seeded so every run replays the same sequence
+static uint32_t hostRandomState = 0x9E3779B9;
+
+uint32_t millis() {
+    return (uint32_t)(hostMicros / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)hostMicros;
+}
+
+void delay(uint32_t ms) {
+    hostAdvanceMillis(ms);
+}
+
+void hostSetMillis(uint32_t ms) {
+    hostMicros = (uint64_t)ms * 1000;
+}
+
+void hostAdvanceMillis(uint32_t ms) {
+    hostMicros += (uint64_t)ms * 1000;
+}
+
+static uint32_t nextRandom() {
+    uint32_t x = hostRandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    hostRandomState = x;
+    return x;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) {
+        return 0;
+    }
+    return nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+    // xorshift must never be seeded with zero
+    if (seed != 0) {
+        hostRandomState = (uint32_t)seed;
+    }
+}
+
+uint32_t esp_random() {
+    return nextRandom();
+}
+
+int analogRead(uint8_t pin) {
+    // a floating pin reads as noise, a few bits at most
+    return random(16);
+}
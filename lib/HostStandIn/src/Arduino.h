@@ -0,0 +1,35 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the LED code uses.
+// Time comes from a virtual clock that only moves when the host driver
+// advances it, so runs are repeatable and independent of host speed.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+#define PROGMEM
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+int analogRead(uint8_t pin);
+
+// the ESP32 hardware RNG, here the same repeatable sequence as random()
+uint32_t esp_random();
+
+// Virtual clock control, host only
+void hostSetMillis(uint32_t ms);
+void hostAdvanceMillis(uint32_t ms);
+
+#endif
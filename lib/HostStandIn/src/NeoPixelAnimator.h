@@ -0,0 +1,206 @@
+#ifndef HOST_NEOPIXELANIMATOR_H
+#define HOST_NEOPIXELANIMATOR_H
+
+// Host stand-in for NeoPixelAnimator and NeoEase, timing follows the
+// library: whole time-scale units are consumed per update and the
+// remainder is dropped, so effects step exactly as they do on the device.
+
+#include <Arduino.h>
+#include <functional>
+
+enum AnimationState {
+    AnimationState_Started,
+    AnimationState_Progress,
+    AnimationState_Completed
+};
+
+struct AnimationParam {
+    float progress;
+    uint16_t index;
+    AnimationState state;
+};
+
+typedef std::function<void(const AnimationParam& param)> AnimUpdateCallback;
+typedef std::function<float(float unitValue)> AnimEaseFunction;
+
+#define NEO_MILLISECONDS        1    // ~65 seconds max duration, ms updates
+#define NEO_CENTISECONDS       10    // ~10.9 minutes max duration, centisecond updates
+#define NEO_DECISECONDS       100    // ~1.8 hours max duration, decisecond updates
+#define NEO_SECONDS          1000    // ~18.2 hours max duration, second updates
+#define NEO_DECASECONDS     10000    // ~7.5 days, 10 second updates
+
+class NeoPixelAnimator {
+public:
+    NeoPixelAnimator(uint16_t countAnimations, uint16_t timeScale = NEO_MILLISECONDS);
+    ~NeoPixelAnimator();
+
+    bool IsAnimating() const {
+        return _activeAnimations > 0;
+    }
+
+    bool NextAvailableAnimation(uint16_t* indexAvailable, uint16_t indexStart = 0);
+
+    void StartAnimation(uint16_t indexAnimation, uint16_t duration, AnimUpdateCallback animUpdate);
+    void StopAnimation(uint16_t indexAnimation);
+    void StopAll();
+
+    void RestartAnimation(uint16_t indexAnimation) {
+        if (indexAnimation >= _countAnimations || _animations[indexAnimation]._duration == 0) {
+            return;
+        }
+        StartAnimation(indexAnimation, _animations[indexAnimation]._duration, (_animations[indexAnimation])._fnCallback);
+    }
+
+    bool IsAnimationActive(uint16_t indexAnimation) const {
+        if (indexAnimation >= _countAnimations) {
+            return false;
+        }
+        return (IsAnimating() && _animations[indexAnimation]._remaining != 0);
+    }
+
+    uint16_t AnimationDuration(uint16_t indexAnimation) {
+        if (indexAnimation >= _countAnimations) {
+            return 0;
+        }
+        return _animations[indexAnimation]._duration;
+    }
+
+    void UpdateAnimations();
+
+    bool IsPaused() {
+        return (!_isRunning);
+    }
+
+    void Pause() {
+        _isRunning = false;
+    }
+
+    void Resume() {
+        _isRunning = true;
+        _animationLastTick = millis();
+    }
+
+    uint16_t getTimeScale() {
+        return _timeScale;
+    }
+
+    void setTimeScale(uint16_t timeScale) {
+        _timeScale = (timeScale < 1) ? (1) : (timeScale > 32768) ? 32768 : timeScale;
+    }
+
+private:
+    struct AnimationContext {
+        AnimationContext() : _duration(0), _remaining(0), _fnCallback(nullptr) {}
+
+        void StartAnimation(uint16_t duration, AnimUpdateCallback animUpdate) {
+            _duration = duration;
+            _remaining = duration;
+            _fnCallback = animUpdate;
+        }
+
+        void StopAnimation() {
+            _remaining = 0;
+        }
+
+        float CurrentProgress() {
+            return (float)(_duration - _remaining) / (float)_duration;
+        }
+
+        uint16_t _duration;
+        uint16_t _remaining;
+        AnimUpdateCallback _fnCallback;
+    };
+
+    uint16_t _countAnimations;
+    AnimationContext* _animations;
+    uint32_t _animationLastTick;
+    uint16_t _activeAnimations;
+    uint16_t _timeScale;
+    bool _isRunning;
+};
+
+class NeoEase {
+public:
+    static float Linear(float unitValue) {
+        return unitValue;
+    }
+
+    static float QuadraticIn(float unitValue) {
+        return unitValue * unitValue;
+    }
+
+    static float QuadraticOut(float unitValue) {
+        return (-unitValue * (unitValue - 2.0f));
+    }
+
+    static float QuadraticInOut(float unitValue) {
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return (0.5f * unitValue * unitValue);
+        }
+        unitValue -= 1.0f;
+        return (-0.5f * (unitValue * (unitValue - 2.0f) - 1.0f));
+    }
+
+    static float CubicIn(float unitValue) {
+        return (unitValue * unitValue * unitValue);
+    }
+
+    static float CubicOut(float unitValue) {
+        unitValue -= 1.0f;
+        return (unitValue * unitValue * unitValue + 1);
+    }
+
+    static float CubicInOut(float unitValue) {
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return (0.5f * unitValue * unitValue * unitValue);
+        }
+        unitValue -= 2.0f;
+        return (0.5f * (unitValue * unitValue * unitValue + 2.0f));
+    }
+
+    static float QuarticInOut(float unitValue) {
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return (0.5f * unitValue * unitValue * unitValue * unitValue);
+        }
+        unitValue -= 2.0f;
+        return (-0.5f * (unitValue * unitValue * unitValue * unitValue - 2.0f));
+    }
+
+    static float QuinticInOut(float unitValue) {
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return (0.5f * unitValue * unitValue * unitValue * unitValue * unitValue);
+        }
+        unitValue -= 2.0f;
+        return (0.5f * (unitValue * unitValue * unitValue * unitValue * unitValue + 2.0f));
+    }
+
+    static float SinusoidalInOut(float unitValue) {
+        return -0.5f * (cosf(float(M_PI) * unitValue) - 1.0f);
+    }
+
+    static float ExponentialInOut(float unitValue) {
+        if (unitValue == 0.0f || unitValue == 1.0f) {
+            return unitValue;
+        }
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return 0.5f * powf(2.0f, 10.0f * (unitValue - 1.0f));
+        }
+        return 0.5f * (-powf(2.0f, -10.0f * (unitValue - 1.0f)) + 2.0f);
+    }
+
+    static float CircularInOut(float unitValue) {
+        unitValue *= 2.0f;
+        if (unitValue < 1.0f) {
+            return (-0.5f * (sqrtf(1.0f - unitValue * unitValue) - 1.0f));
+        }
+        unitValue -= 2.0f;
+        return (0.5f * (sqrtf(1.0f - unitValue * unitValue) + 1.0f));
+    }
+};
+
+#endif
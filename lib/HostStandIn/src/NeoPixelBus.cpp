@@ -0,0 +1,41 @@
+#include <NeoPixelBus.h>
+
+#include <map>
+#include <vector>
+
+struct PinWire {
+    std::vector<uint8_t> data;
+    HostWire wire;
+};
+
+static std::map<uint8_t, PinWire> pinWires;
+static HostWire wire = { nullptr, 0, 0 };
+static const HostWire silentWire = { nullptr, 0, 0 };
+
+const HostWire& hostWire() {
+    return wire;
+}
+
+const HostWire& hostWire(uint8_t pin) {
+    std::map<uint8_t, PinWire>::const_iterator found = pinWires.find(pin);
+    if (found == pinWires.end()) {
+        return silentWire;
+    }
+    return found->second.wire;
+}
+
+void hostWireSend(uint8_t pin, const uint8_t* data, size_t size) {
+    PinWire& pinWire = pinWires[pin];
+    if (pinWire.data.size() != size) {
+        pinWire.data.resize(size);
+    }
+    memcpy(pinWire.data.data(), data, size);
+
+    pinWire.wire.data = pinWire.data.data();
+    pinWire.wire.size = size;
+    pinWire.wire.showCount++;
+
+    wire.data = pinWire.wire.data;
+    wire.size = size;
+    wire.showCount++;
+}
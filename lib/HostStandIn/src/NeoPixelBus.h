@@ -0,0 +1,445 @@
+#ifndef HOST_NEOPIXELBUS_H
+#define HOST_NEOPIXELBUS_H
+
+// Host stand-in for the subset of NeoPixelBus the LED code uses.
+// Colour maths follows the library so effects render the same values,
+// the "wire" is an in-memory copy of the buffer taken on every Show().
+
+#include <Arduino.h>
+
+struct HtmlColor {
+    HtmlColor(uint32_t color = 0) : Color(color) {}
+    uint32_t Color;
+};
+
+struct HslColor {
+    HslColor(float h = 0.0f, float s = 0.0f, float l = 0.0f) : H(h), S(s), L(l) {}
+    float H;
+    float S;
+    float L;
+};
+
+struct RgbColor {
+    static const uint8_t Max = 255;
+
+    RgbColor(uint8_t r, uint8_t g, uint8_t b) : R(r), G(g), B(b) {}
+    RgbColor(uint8_t brightness) : R(brightness), G(brightness), B(brightness) {}
+    RgbColor() : R(0), G(0), B(0) {}
+
+    RgbColor(const HtmlColor& color) :
+        R((color.Color >> 16) & 0xff),
+        G((color.Color >> 8) & 0xff),
+        B(color.Color & 0xff) {
+    }
+
+    RgbColor(const HslColor& color) {
+        float r;
+        float g;
+        float b;
+        float h = color.H;
+        float s = color.S;
+        float l = color.L;
+
+        if (s == 0.0f || l == 0.0f) {
+            r = g = b = l; // achromatic or black
+        }
+        else {
+            float q = l < 0.5f ? l * (1.0f + s) : l + s - (l * s);
+            float p = 2.0f * l - q;
+            r = CalcColor(p, q, h + 1.0f / 3.0f);
+            g = CalcColor(p, q, h);
+            b = CalcColor(p, q, h - 1.0f / 3.0f);
+        }
+
+        R = (uint8_t)(r * Max);
+        G = (uint8_t)(g * Max);
+        B = (uint8_t)(b * Max);
+    }
+
+    bool operator==(const RgbColor& other) const {
+        return (R == other.R && G == other.G && B == other.B);
+    }
+
+    bool operator!=(const RgbColor& other) const {
+        return !(*this == other);
+    }
+
+    void Darken(uint8_t delta) {
+        R = (R > delta) ? R - delta : 0;
+        G = (G > delta) ? G - delta : 0;
+        B = (B > delta) ? B - delta : 0;
+    }
+
+    void Lighten(uint8_t delta) {
+        R = (R < Max - delta) ? R + delta : Max;
+        G = (G < Max - delta) ? G + delta : Max;
+        B = (B < Max - delta) ? B + delta : Max;
+    }
+
+    uint8_t CalculateBrightness() const {
+        return (uint8_t)(((uint16_t)R + (uint16_t)G + (uint16_t)B) / 3);
+    }
+
+    static RgbColor LinearBlend(const RgbColor& left, const RgbColor& right, float progress) {
+        return RgbColor(
+            left.R + ((static_cast<int16_t>(right.R) - left.R) * progress),
+            left.G + ((static_cast<int16_t>(right.G) - left.G) * progress),
+            left.B + ((static_cast<int16_t>(right.B) - left.B) * progress));
+    }
+
+    static RgbColor LinearBlend(const RgbColor& left, const RgbColor& right, uint8_t progress) {
+        return RgbColor(
+            left.R + ((static_cast<int32_t>(right.R) - left.R) * (static_cast<int32_t>(progress) + 1) >> 8),
+            left.G + ((static_cast<int32_t>(right.G) - left.G) * (static_cast<int32_t>(progress) + 1) >> 8),
+            left.B + ((static_cast<int32_t>(right.B) - left.B) * (static_cast<int32_t>(progress) + 1) >> 8));
+    }
+
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+
+private:
+    static float CalcColor(float p, float q, float t) {
+        if (t < 0.0f) t += 1.0f;
+        if (t > 1.0f) t -= 1.0f;
+        if (t < 1.0f / 6.0f) return p + (q - p) * 6.0f * t;
+        if (t < 0.5f) return q;
+        if (t < 2.0f / 3.0f) return p + ((q - p) * (2.0f / 3.0f - t) * 6.0f);
+        return p;
+    }
+};
+
+struct RgbwColor {
+    RgbwColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) : R(r), G(g), B(b), W(w) {}
+    RgbwColor(uint8_t brightness) : R(0), G(0), B(0), W(brightness) {}
+    RgbwColor(const RgbColor& color) : R(color.R), G(color.G), B(color.B), W(0) {}
+    RgbwColor() : R(0), G(0), B(0), W(0) {}
+
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+    uint8_t W;
+};
+
+// The library's other colour types, not used by the LED code but declared
+// so a type of ours that takes one of their names fails on the host as it
+// would on the device
+struct Rgb16Color {
+    uint16_t Color565;
+};
+
+struct Rgb48Color {
+    uint16_t R;
+    uint16_t G;
+    uint16_t B;
+};
+
+struct Rgbw64Color {
+    uint16_t R;
+    uint16_t G;
+    uint16_t B;
+    uint16_t W;
+};
+
+struct RgbwwColor {
+    uint8_t R;
+    uint8_t G;
+    uint8_t B;
+    uint8_t WW;
+    uint8_t CW;
+};
+
+struct Rgbww80Color {
+    uint16_t R;
+    uint16_t G;
+    uint16_t B;
+    uint16_t WW;
+    uint16_t CW;
+};
+
+struct HsbColor {
+    float H;
+    float S;
+    float B;
+};
+
+// Colour features, the byte order the pixels are stored and sent in
+class NeoGrbFeature {
+public:
+    typedef RgbColor ColorObject;
+    static const size_t PixelSize = 3;
+
+    static void applyPixelColor(uint8_t* pixels, uint16_t indexPixel, ColorObject color) {
+        uint8_t* p = pixels + indexPixel * PixelSize;
+        *p++ = color.G;
+        *p++ = color.R;
+        *p = color.B;
+    }
+
+    static ColorObject retrievePixelColor(const uint8_t* pixels, uint16_t indexPixel) {
+        const uint8_t* p = pixels + indexPixel * PixelSize;
+        ColorObject color;
+        color.G = *p++;
+        color.R = *p++;
+        color.B = *p;
+        return color;
+    }
+};
+
+class NeoRgbFeature {
+public:
+    typedef RgbColor ColorObject;
+    static const size_t PixelSize = 3;
+
+    static void applyPixelColor(uint8_t* pixels, uint16_t indexPixel, ColorObject color) {
+        uint8_t* p = pixels + indexPixel * PixelSize;
+        *p++ = color.R;
+        *p++ = color.G;
+        *p = color.B;
+    }
+
+    static ColorObject retrievePixelColor(const uint8_t* pixels, uint16_t indexPixel) {
+        const uint8_t* p = pixels + indexPixel * PixelSize;
+        ColorObject color;
+        color.R = *p++;
+        color.G = *p++;
+        color.B = *p;
+        return color;
+    }
+};
+
+class NeoGrbwFeature {
+public:
+    typedef RgbwColor ColorObject;
+    static const size_t PixelSize = 4;
+
+    static void applyPixelColor(uint8_t* pixels, uint16_t indexPixel, ColorObject color) {
+        uint8_t* p = pixels + indexPixel * PixelSize;
+        *p++ = color.G;
+        *p++ = color.R;
+        *p++ = color.B;
+        *p = color.W;
+    }
+
+    static ColorObject retrievePixelColor(const uint8_t* pixels, uint16_t indexPixel) {
+        const uint8_t* p = pixels + indexPixel * PixelSize;
+        ColorObject color;
+        color.G = *p++;
+        color.R = *p++;
+        color.B = *p++;
+        color.W = *p;
+        return color;
+    }
+};
+
+class NeoRgbwFeature {
+public:
+    typedef RgbwColor ColorObject;
+    static const size_t PixelSize = 4;
+
+    static void applyPixelColor(uint8_t* pixels, uint16_t indexPixel, ColorObject color) {
+        uint8_t* p = pixels + indexPixel * PixelSize;
+        *p++ = color.R;
+        *p++ = color.G;
+        *p++ = color.B;
+        *p = color.W;
+    }
+
+    static ColorObject retrievePixelColor(const uint8_t* pixels, uint16_t indexPixel) {
+        const uint8_t* p = pixels + indexPixel * PixelSize;
+        ColorObject color;
+        color.R = *p++;
+        color.G = *p++;
+        color.B = *p++;
+        color.W = *p;
+        return color;
+    }
+};
+
+// Output methods, all the same on the host
+class NeoHostMethod {
+};
+typedef NeoHostMethod NeoWs2812xMethod;
+typedef NeoHostMethod NeoEsp32Rmt0Ws2812xMethod;
+typedef NeoHostMethod NeoEsp32Rmt1Ws2812xMethod;
+typedef NeoHostMethod NeoEsp32Rmt2Ws2812xMethod;
+typedef NeoHostMethod NeoEsp32Rmt3Ws2812xMethod;
+
+// What the last Show() put on the "wire", host only. hostWire() is
+// whichever strip showed last and counts the shows of every strip,
+// hostWire(pin) only follows the strip on that pin
+struct HostWire {
+    const uint8_t* data;
+    size_t size;
+    uint32_t showCount;
+};
+const HostWire& hostWire();
+const HostWire& hostWire(uint8_t pin);
+void hostWireSend(uint8_t pin, const uint8_t* data, size_t size);
+
+template <typename T_COLOR_FEATURE, typename T_METHOD> class NeoPixelBus {
+public:
+    NeoPixelBus(uint16_t countPixels, uint8_t pin) :
+        _pin(pin),
+        _countPixels(countPixels),
+        _pixelsSize(countPixels * T_COLOR_FEATURE::PixelSize),
+        _pixels(new uint8_t[countPixels * T_COLOR_FEATURE::PixelSize]()),
+        _dirty(true) {
+    }
+
+    ~NeoPixelBus() {
+        delete[] _pixels;
+    }
+
+    void Begin() {
+        ClearTo(0);
+    }
+
+    void Show(bool maintainBufferConsistency = true) {
+        if (!IsDirty()) {
+            return;
+        }
+        hostWireSend(_pin, _pixels, _pixelsSize);
+        ResetDirty();
+    }
+
+    bool CanShow() const {
+        return true;
+    }
+
+    bool IsDirty() const {
+        return _dirty;
+    }
+
+    void Dirty() {
+        _dirty = true;
+    }
+
+    void ResetDirty() {
+        _dirty = false;
+    }
+
+    uint8_t* Pixels() {
+        return _pixels;
+    }
+
+    size_t PixelsSize() const {
+        return _pixelsSize;
+    }
+
+    size_t PixelSize() const {
+        return T_COLOR_FEATURE::PixelSize;
+    }
+
+    uint16_t PixelCount() const {
+        return _countPixels;
+    }
+
+    void SetPixelColor(uint16_t indexPixel, typename T_COLOR_FEATURE::ColorObject color) {
+        if (indexPixel < _countPixels) {
+            T_COLOR_FEATURE::applyPixelColor(_pixels, indexPixel, color);
+            Dirty();
+        }
+    }
+
+    typename T_COLOR_FEATURE::ColorObject GetPixelColor(uint16_t indexPixel) const {
+        if (indexPixel < _countPixels) {
+            return T_COLOR_FEATURE::retrievePixelColor(_pixels, indexPixel);
+        }
+        return 0;
+    }
+
+    template <typename T_COLOROBJECT> T_COLOROBJECT GetPixelColor(uint16_t indexPixel) const {
+        return GetPixelColor(indexPixel);
+    }
+
+    void ClearTo(typename T_COLOR_FEATURE::ColorObject color) {
+        for (uint16_t index = 0; index < _countPixels; index++) {
+            T_COLOR_FEATURE::applyPixelColor(_pixels, index, color);
+        }
+        Dirty();
+    }
+
+    void ClearTo(typename T_COLOR_FEATURE::ColorObject color, uint16_t first, uint16_t last) {
+        if (first < _countPixels && last < _countPixels && first <= last) {
+            for (uint16_t index = first; index <= last; index++) {
+                T_COLOR_FEATURE::applyPixelColor(_pixels, index, color);
+            }
+            Dirty();
+        }
+    }
+
+    void RotateLeft(uint16_t rotationCount) {
+        if ((_countPixels - 1) >= rotationCount) {
+            rotateLeft(rotationCount, 0, _countPixels - 1);
+        }
+    }
+
+    void RotateRight(uint16_t rotationCount) {
+        if ((_countPixels - 1) >= rotationCount) {
+            rotateRight(rotationCount, 0, _countPixels - 1);
+        }
+    }
+
+private:
+    void rotateLeft(uint16_t rotationCount, uint16_t first, uint16_t last) {
+        const size_t pixelSize = T_COLOR_FEATURE::PixelSize;
+        uint8_t temp[rotationCount * pixelSize];
+        uint8_t* front = _pixels + first * pixelSize;
+        size_t rotateSize = rotationCount * pixelSize;
+        size_t moveSize = (last - first + 1) * pixelSize - rotateSize;
+        memcpy(temp, front, rotateSize);
+        memmove(front, front + rotateSize, moveSize);
+        memcpy(front + moveSize, temp, rotateSize);
+        Dirty();
+    }
+
+    void rotateRight(uint16_t rotationCount, uint16_t first, uint16_t last) {
+        const size_t pixelSize = T_COLOR_FEATURE::PixelSize;
+        uint8_t temp[rotationCount * pixelSize];
+        uint8_t* front = _pixels + first * pixelSize;
+        size_t rotateSize = rotationCount * pixelSize;
+        size_t moveSize = (last - first + 1) * pixelSize - rotateSize;
+        memcpy(temp, front + moveSize, rotateSize);
+        memmove(front + rotateSize, front, moveSize);
+        memcpy(front, temp, rotateSize);
+        Dirty();
+    }
+
+    const uint8_t _pin;
+    const uint16_t _countPixels;
+    const size_t _pixelsSize;
+    uint8_t* _pixels;
+    bool _dirty;
+};
+
+// Gamma correction, the table is built from the same 1/0.45 curve the library ships
+class NeoGammaTableMethod {
+public:
+    static uint8_t Correct(uint8_t value) {
+        static const Table table;
+        return table.values[value];
+    }
+
+private:
+    struct Table {
+        Table() {
+            for (int index = 0; index < 256; index++) {
+                values[index] = (uint8_t)(powf(index / 255.0f, 1.0f / 0.45f) * 255.0f + 0.5f);
+            }
+        }
+        uint8_t values[256];
+    };
+};
+
+template <typename T_METHOD> class NeoGamma {
+public:
+    static RgbColor Correct(const RgbColor& original) {
+        return RgbColor(
+            T_METHOD::Correct(original.R),
+            T_METHOD::Correct(original.G),
+            T_METHOD::Correct(original.B));
+    }
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include <Preferences.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::vector<uint8_t> > Namespace;
+
+static std::map<std::string, Namespace> storage;
+
+void hostClearPreferences() {
+    storage.clear();
+}
+
+Preferences::Preferences() :
+    _namespace(NULL),
+    _readOnly(false) {
+}
+
+Preferences::~Preferences() {
+    end();
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+    if (_namespace != NULL || name == NULL || strlen(name) > 15) {
+        return false;
+    }
+    _namespace = &storage[name];
+    _readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end() {
+    _namespace = NULL;
+}
+
+bool Preferences::clear() {
+    if (_namespace == NULL || _readOnly) {
+        return false;
+    }
+    static_cast<Namespace*>(_namespace)->clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (_namespace == NULL || _readOnly) {
+        return false;
+    }
+    return static_cast<Namespace*>(_namespace)->erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return _namespace != NULL && static_cast<Namespace*>(_namespace)->count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (_namespace == NULL || _readOnly || key == NULL || strlen(key) > 15) {
+        return 0;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    (*static_cast<Namespace*>(_namespace))[key].assign(bytes, bytes + len);
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!isKey(key)) {
+        return 0;
+    }
+    return (*static_cast<Namespace*>(_namespace))[key].size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen) {
+        return 0;
+    }
+    memcpy(buf, (*static_cast<Namespace*>(_namespace))[key].data(), len);
+    return len;
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+    return getValue(key, defaultValue);
+}
+
+size_t Preferences::putUShort(const char* key, uint16_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue) {
+    return getValue(key, defaultValue);
+}
+
+size_t Preferences::putULong(const char* key, uint32_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getULong(const char* key, uint32_t defaultValue) {
+    return getValue(key, defaultValue);
+}
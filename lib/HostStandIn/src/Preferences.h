@@ -0,0 +1,49 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host stand-in for the arduino-esp32 NVS wrapper. Namespaces live in
+// memory for the life of the process, which is enough to exercise the
+// save and restore paths.
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    Preferences();
+    ~Preferences();
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = NULL);
+    void end();
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+    size_t putUChar(const char* key, uint8_t value);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    size_t putUShort(const char* key, uint16_t value);
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+    size_t putULong(const char* key, uint32_t value);
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0);
+
+private:
+    template <typename T> T getValue(const char* key, T defaultValue) {
+        T value;
+        if (getBytesLength(key) != sizeof(T) || getBytes(key, &value, sizeof(T)) != sizeof(T)) {
+            return defaultValue;
+        }
+        return value;
+    }
+
+    void* _namespace;
+    bool _readOnly;
+};
+
+// Forget everything saved, host only
+void hostClearPreferences();
+
+#endif
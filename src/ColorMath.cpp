@@ -0,0 +1,41 @@
+#include <ColorMath.h>
+
+EaseTable::EaseTable(EaseFunction curve) {
+    for (uint16_t index = 0; index <= Segments; index++) {
+        float value = curve((float)index / Segments);
+        _values[index] = (uint32_t)(value * Q16One + 0.5f);
+    }
+}
+
+void DarkenChannels(uint16_t* channels, size_t count, uint16_t darkenBy) {
+    if (darkenBy == 0) {
+        return;
+    }
+    uint16_t* end = channels + count;
+
+    // one channel if it doesn't start on a word boundary
+    if (((uintptr_t)channels & 3) != 0 && channels < end) {
+        *channels = (*channels > darkenBy) ? *channels - darkenBy : 0;
+        channels++;
+    }
+
+    // subtract from both channels of a word at once, the top bit of each
+    // channel is handled apart so no borrow crosses into the other one,
+    // then any channel that did borrow went below zero and is cleared
+    const uint32_t high = 0x80008000;
+    const uint32_t darken = darkenBy * 0x00010001U;
+    ChannelPair* words = reinterpret_cast<ChannelPair*>(channels);
+    ChannelPair* wordsEnd = words + (end - channels) / 2;
+    while (words < wordsEnd) {
+        uint32_t value = *words;
+        uint32_t difference = ((value | high) - (darken & ~high)) ^ ((value ^ ~darken) & high);
+        uint32_t borrow = ((~value & darken) | (~(value ^ darken) & difference)) & high;
+        *words++ = difference & ~((borrow >> 15) * 0xffff);
+    }
+
+    // and the last one if there's an odd one left over
+    channels = reinterpret_cast<uint16_t*>(words);
+    if (channels < end) {
+        *channels = (*channels > darkenBy) ? *channels - darkenBy : 0;
+    }
+}
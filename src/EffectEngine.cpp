@@ -0,0 +1,187 @@
+#include <EffectEngine.h>
+
+/* EFFECT ARENA */
+EffectArena::EffectArena(uint8_t* memory, size_t size) :
+    _memory(memory),
+    _size(size),
+    _used(0) {
+}
+
+void* EffectArena::Allocate(size_t size, size_t alignment) {
+    size_t start = (_used + alignment - 1) & ~(alignment - 1);
+    if (start + size > _size) {
+        return NULL;
+    }
+    _used = start + size;
+    return _memory + start;
+}
+
+void EffectArena::Reset() {
+    _used = 0;
+}
+
+
+/* EFFECT CLOCK */
+EffectClock effectClock;
+
+EffectClock::EffectClock() :
+    _lastTick(0),
+    _millis(0),
+    _fraction(0),
+    _speed(100),
+    _effectSpeed(100),
+    _started(false) {
+}
+
+void EffectClock::Advance(uint32_t nowMillis) {
+    if (!_started) {
+        _started = true;
+        _lastTick = nowMillis;
+        return;
+    }
+
+    // 64 bits so a long gap between frames at a high speed can't overflow,
+    // and the remainder is kept so slow speeds don't lose time to rounding
+    uint64_t scaled = (uint64_t)(nowMillis - _lastTick) * _speed * _effectSpeed + _fraction;
+    _lastTick = nowMillis;
+    _millis += (uint32_t)(scaled / 10000);
+    _fraction = (uint32_t)(scaled % 10000);
+}
+
+
+/* EFFECT RANDOM */
+EffectRandom effectRandom;
+
+
+/* EFFECT ANIMATOR */
+EffectAnimator::EffectAnimator(EffectArena& arena, void* context, uint16_t countAnimations, uint16_t timeScale) :
+    _context(context),
+    _countAnimations(countAnimations),
+    _animationLastTick(0),
+    _activeAnimations(0),
+    _timeScale(timeScale < 1 ? 1 : timeScale) {
+    _animations = arena.Allocate<AnimationContext>(countAnimations);
+    if (_animations == NULL) {
+        // out of arena, behave as an animator with no channels
+        _countAnimations = 0;
+        return;
+    }
+    for (uint16_t index = 0; index < _countAnimations; index++) {
+        _animations[index].duration = 0;
+        _animations[index].remaining = 0;
+        _animations[index].fnCallback = NULL;
+    }
+}
+
+bool EffectAnimator::NextAvailableAnimation(uint16_t* indexAvailable, uint16_t indexStart) {
+    if (_countAnimations == 0) {
+        return false;
+    }
+    if (indexStart >= _countAnimations) {
+        // last one
+        indexStart = _countAnimations - 1;
+    }
+
+    uint16_t next = indexStart;
+    do {
+        if (!IsAnimationActive(next)) {
+            if (indexAvailable) {
+                *indexAvailable = next;
+            }
+            return true;
+        }
+        next = (next + 1) % _countAnimations;
+    } while (next != indexStart);
+    return false;
+}
+
+void EffectAnimator::StartAnimation(uint16_t indexAnimation, uint16_t duration, AnimUpdateFunction animUpdate) {
+    if (indexAnimation >= _countAnimations || animUpdate == NULL) {
+        return;
+    }
+
+    if (_activeAnimations == 0) {
+        _animationLastTick = effectClock.Millis();
+    }
+
+    StopAnimation(indexAnimation);
+
+    // all animations must have at least non zero duration, otherwise
+    // they are considered stopped
+    if (duration == 0) {
+        duration = 1;
+    }
+
+    _activeAnimations++;
+    _animations[indexAnimation].duration = duration;
+    _animations[indexAnimation].remaining = duration;
+    _animations[indexAnimation].fnCallback = animUpdate;
+}
+
+void EffectAnimator::StopAnimation(uint16_t indexAnimation) {
+    if (IsAnimationActive(indexAnimation)) {
+        _activeAnimations--;
+        _animations[indexAnimation].remaining = 0;
+    }
+}
+
+void EffectAnimator::StopAll() {
+    for (uint16_t index = 0; index < _countAnimations; index++) {
+        _animations[index].remaining = 0;
+    }
+    _activeAnimations = 0;
+}
+
+void EffectAnimator::RestartAnimation(uint16_t indexAnimation) {
+    if (indexAnimation >= _countAnimations || _animations[indexAnimation].duration == 0) {
+        return;
+    }
+
+    // restarts are usually made from inside the callback itself, so
+    // leave it in place and only rewind the timer
+    if (_activeAnimations == 0) {
+        _animationLastTick = effectClock.Millis();
+    }
+    if (!IsAnimationActive(indexAnimation)) {
+        _activeAnimations++;
+    }
+    _animations[indexAnimation].remaining = _animations[indexAnimation].duration;
+}
+
+void EffectAnimator::UpdateAnimations() {
+    uint32_t currentTick = effectClock.Millis();
+    uint32_t delta = currentTick - _animationLastTick;
+
+    if (delta < _timeScale) {
+        return;
+    }
+
+    // scale delta into animation time
+    delta /= _timeScale;
+
+    for (uint16_t index = 0; index < _countAnimations; index++) {
+        AnimationContext& anim = _animations[index];
+        EffectParam param;
+        param.index = index;
+
+        if (anim.remaining > delta) {
+            param.state = (anim.remaining == anim.duration) ? AnimationState_Started : AnimationState_Progress;
+            param.progress = ((uint32_t)(anim.duration - anim.remaining) << 16) / anim.duration;
+
+            anim.fnCallback(_context, param);
+
+            anim.remaining -= delta;
+        }
+        else if (anim.remaining > 0) {
+            param.state = AnimationState_Completed;
+            param.progress = Q16One;
+
+            _activeAnimations--;
+            anim.remaining = 0;
+
+            anim.fnCallback(_context, param);
+        }
+    }
+
+    _animationLastTick = currentTick;
+}
@@ -1,88 +1,289 @@
 #include <EffectSelectorPage.h>
+#include <LEDController.h>
+#include <IndexPage.h>
+#include <RenderTask.h>
 
 
 // Create AsyncWebServer object on port 80
 AsyncWebServer server(80);
+// Control socket the page sends its changes over and gets the state back on
+AsyncWebSocket ws("/ws");
 
 const char* PARAM_INPUT_1 = "output";
 const char* PARAM_INPUT_2 = "state";
 
-int selectedAnimation = 0;
+volatile uint32_t loopIterations = 0;
 
-String outputState(int output) {
-    if(digitalRead(output)) {
-        return "checked";
+// "5,6" style list from the /strip parameters, returns how many were read
+uint8_t parseList(const String& list, long* values, uint8_t maxValues) {
+    uint8_t count = 0;
+    int start = 0;
+    while (start <= (int)list.length()) {
+        int comma = list.indexOf(',', start);
+        if (comma < 0) {
+            comma = list.length();
+        }
+        if (count == maxValues) {
+            return maxValues + 1; // too many
+        }
+        values[count++] = list.substring(start, comma).toInt();
+        start = comma + 1;
     }
-    else {
-        return "";
+    return count;
+}
+
+String outputText(const OutputSettings& settings) {
+    return "gamma=" + String(settings.gamma, 2) +
+        "&brightness=" + String(settings.brightness) +
+        "&white=" + String(settings.whiteBalance.R) + "," +
+        String(settings.whiteBalance.G) + "," + String(settings.whiteBalance.B) +
+        "&dither=" + String(settings.dither ? 1 : 0);
+}
+
+uint32_t packColour(const RgbColor& colour) {
+    return ((uint32_t)colour.R << 16) | ((uint32_t)colour.G << 8) | colour.B;
+}
+
+String layoutText(const StripLayout& layout) {
+    String pins = "";
+    String counts = "";
+    for (uint8_t segment = 0; segment < layout.segmentCount; segment++) {
+        if (segment > 0) {
+            pins += ",";
+            counts += ",";
+        }
+        pins += layout.segments[segment].pin;
+        counts += layout.segments[segment].count;
     }
+    return "pins=" + pins + "&counts=" + counts;
 }
 
-// Replaces placeholder with button section in your web page
-String processor(const String& var){
-  //Serial.println(var);
-  if(var == "BUTTONPLACEHOLDER"){
-    String buttons = "";
-    buttons += "<h4>Basic Pattern</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"1\" " + outputState(1) + "><span class=\"slider\"></span></label>";
-    buttons += "<h4>Fade In Fade Out</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"2\" " + outputState(2) + "><span class=\"slider\"></span></label>";
-    buttons += "<h4>Random Change</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"3\" " + outputState(3) + "><span class=\"slider\"></span></label>";
-    buttons += "<h4>Rotating Loop</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"4\" " + outputState(4) + "><span class=\"slider\"></span></label>";
-    buttons += "<h4>Bounce</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"5\" " + outputState(5) + "><span class=\"slider\"></span></label>";
-    buttons += "<h4>Fancy Rotating Loop</h4><label class=\"switch\"><input type=\"checkbox\" onchange=\"toggleCheckbox(this)\" id=\"6\" " + outputState(6) + "><span class=\"slider\"></span></label>";
-    return buttons;
-  }
-  return String();
+
+/* CONTROL SOCKET */
+// A binary message is a batch of 5 byte records, the CommandType then its
+// value as 4 bytes little endian, so one message can move several sliders
+const size_t CommandRecordSize = 5;
+// clients are sent the state at most this often, however fast it changes
+const uint32_t StatePushInterval = 50; // ms
+
+// the newest value of each type not queued yet. A batch only ever queues
+// one command per type, and anything the queue had no room for is tried
+// again with the next message
+uint32_t heldValues[CommandTypeCount];
+uint16_t heldTypes = 0;
+
+bool isValidCommand(uint8_t type, uint32_t value) {
+    switch (type) {
+    case Command_SetEffect:
+        return value < (uint32_t)getEffectCount();
+    case Command_SetColour:
+    case Command_SetWhiteBalance:
+        return value <= 0xffffff;
+    case Command_SetSpeed:
+    case Command_SetEffectSpeed:
+        return value <= 1000;
+    case Command_SetBrightness:
+        return value <= 255;
+    case Command_SetGamma:
+        return value >= 100 && value <= 5000;
+    case Command_SetDither:
+        return value <= 1;
+    case Command_SetTransition:
+        return value <= 10000;
+    default:
+        return false;
+    }
 }
 
+// The state as the page shows it, with the effect names as well for /state
+String stateJson(bool withEffects = false) {
+    const OutputSettings settings = getOutputSettings();
+    char fields[220];
+    snprintf(fields, sizeof(fields),
+        "\"effect\":%d,\"colour\":\"%06x\",\"speed\":%u,\"effectSpeed\":%u,\"brightness\":%u,"
+        "\"gamma\":%.2f,\"white\":\"%06x\",\"dither\":%d,\"transition\":%u}",
+        getSelectedEffect(), (unsigned)packColour(getCylonColour()), getEffectSpeed(),
+        getEffectSpeed(getSelectedEffect()), settings.brightness, settings.gamma, (unsigned)packColour(settings.whiteBalance),
+        settings.dither ? 1 : 0, getTransitionTime());
 
-/* WEB SITE CODE */
+    String json = "{";
+    if (withEffects) {
+        json += "\"effects\":[";
+        for (int animation = 0; animation < getEffectCount(); animation++) {
+            if (animation > 0) {
+                json += ",";
+            }
+            json += "\"";
+            json += getEffectName(animation);
+            json += "\"";
+        }
+        json += "],";
+    }
+    json += fields;
+    return json;
+}
 
-const char index_html[] PROGMEM = R"rawliteral(
-<!DOCTYPE HTML><html>
-<head>
-  <title>Infinity Mirror Controller</title>
-  <meta name="viewport" content="width=device-width, initial-scale=1">
-  <link rel="icon" href="data:,">
-  <style>
-    html {font-family: Arial; display: inline-block; text-align: center;}
-    h2 {font-size: 3.0rem;}
-    p {font-size: 3.0rem;}
-    body {max-width: 600px; margin:0px auto; padding-bottom: 25px;}
-    .switch {position: relative; display: inline-block; width: 120px; height: 68px} 
-    .switch input {display: none}
-    .slider {position: absolute; top: 0; left: 0; right: 0; bottom: 0; background-color: #ccc; border-radius: 6px}
-    .slider:before {position: absolute; content: ""; height: 52px; width: 52px; left: 8px; bottom: 8px; background-color: #fff; -webkit-transition: .4s; transition: .4s; border-radius: 3px}
-    input:checked+.slider {background-color: #b30000}
-    input:checked+.slider:before {-webkit-transform: translateX(52px); -ms-transform: translateX(52px); transform: translateX(52px)}
-  </style>
-</head>
-<body>
-  <h2>Infinity Mirror Controller</h2>
-  %BUTTONPLACEHOLDER%
-<script>function toggleCheckbox(element) {
-  var xhr = new XMLHttpRequest();
-  if(element.checked){ xhr.open("GET", "/update?output="+element.id+"&state=1", true); }
-  else { xhr.open("GET", "/update?output="+element.id+"&state=0", true); }
-  xhr.send();
+void postHeldCommands() {
+    for (uint8_t type = 0; type < CommandTypeCount; type++) {
+        if ((heldTypes & (1 << type)) && postCommand((CommandType)type, heldValues[type])) {
+            heldTypes &= ~(1 << type);
+        }
+    }
 }
-</script>
-<h3>Written by David Eldridge 2024<h3>
-</body>
-</html>
-)rawliteral";
 
+void onControlSocketEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client,
+    AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+        client->text(stateJson());
+        return;
+    }
+    if (type != WS_EVT_DATA) {
+        return;
+    }
+
+    // the page's batches are a few records, so anything fragmented or
+    // split over frames isn't ours
+    AwsFrameInfo* info = (AwsFrameInfo*)arg;
+    if (!info->final || info->index != 0 || info->len != len ||
+        info->opcode != WS_BINARY || len % CommandRecordSize != 0) {
+        return;
+    }
+
+    for (size_t offset = 0; offset < len; offset += CommandRecordSize) {
+        uint8_t command = data[offset];
+        uint32_t value = data[offset + 1] | ((uint32_t)data[offset + 2] << 8) |
+            ((uint32_t)data[offset + 3] << 16) | ((uint32_t)data[offset + 4] << 24);
+        if (isValidCommand(command, value)) {
+            heldValues[command] = value;
+            heldTypes |= 1 << command;
+        }
+    }
+    postHeldCommands();
+}
 
+void pushState() {
+    static uint32_t sentVersion = 0;
+    static uint32_t lastPush = 0;
 
+    ws.cleanupClients();
+
+    // every change applied since the last push goes out as one message
+    uint32_t version = getStateVersion();
+    if (version == sentVersion || millis() - lastPush < StatePushInterval) {
+        return;
+    }
+    sentVersion = version;
+    lastPush = millis();
+    if (ws.count() > 0) {
+        ws.textAll(stateJson());
+    }
+}
+
+
+/* METRICS */
+TimeHistogram webTimes;
+
+// Handlers are wrapped so /metrics can report how long a request takes to
+// answer once it reaches the server
+ArRequestHandlerFunction timed(ArRequestHandlerFunction handler) {
+    return [handler] (AsyncWebServerRequest *request) {
+        uint32_t start = micros();
+        handler(request);
+        webTimes.Record(micros() - start);
+    };
+}
+
+String timingJson(const char* name, const TimeHistogram& times) {
+    char json[120];
+    snprintf(json, sizeof(json), "\"%s\":{\"count\":%u,\"min\":%u,\"avg\":%u,\"p99\":%u,\"max\":%u}",
+        name, (unsigned)times.Count(), (unsigned)times.Min(), (unsigned)times.Average(),
+        (unsigned)times.Percentile(99), (unsigned)times.Max());
+    return String(json);
+}
+
+String metricsJson() {
+    // rates are over the time since the last request, so polling every
+    // few seconds shows what the mirror is doing now
+    static uint32_t lastMicros = 0;
+    static uint32_t lastFrames = 0;
+    static uint32_t lastLoops = 0;
+
+    const uint32_t now = micros();
+    const RenderStats stats = getRenderStats();
+    const uint32_t loops = loopIterations;
+    const float seconds = (now - lastMicros) / 1000000.0f;
+    const float fps = (seconds > 0.0f) ? (stats.frames - lastFrames) / seconds : 0.0f;
+    const float loopRate = (seconds > 0.0f) ? (loops - lastLoops) / seconds : 0.0f;
+    lastMicros = now;
+    lastFrames = stats.frames;
+    lastLoops = loops;
+
+    char json[340];
+    snprintf(json, sizeof(json),
+        "{\"fps\":%.1f,\"targetFps\":%u,\"frames\":%u,\"shows\":%u,\"skipped\":%u,\"dropped\":%u,"
+        "\"loopsPerSecond\":%.0f,\"freeHeap\":%u,\"largestFreeBlock\":%u,\"firstFrameUs\":%u,",
+        fps, stats.targetFps, (unsigned)stats.frames, (unsigned)stats.shows, (unsigned)stats.skipped,
+        (unsigned)stats.dropped, loopRate, (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMaxAllocHeap(),
+        (unsigned)getFirstFrameTime());
+
+    const StreamStats stream = getStreamReceiver().Stats();
+    char streamJson[200];
+    snprintf(streamJson, sizeof(streamJson),
+        "\"stream\":{\"packets\":%u,\"lost\":%u,\"outOfOrder\":%u,\"incomplete\":%u,"
+        "\"overruns\":%u,\"frames\":%u,\"skipped\":%u,\"shown\":%u}",
+        (unsigned)stream.packets, (unsigned)stream.lost, (unsigned)stream.outOfOrder,
+        (unsigned)stream.incomplete, (unsigned)stream.overruns, (unsigned)stream.frames,
+        (unsigned)stream.skipped, (unsigned)stream.shown);
+
+    // timings are in us since boot
+    return json + timingJson("frameUs", getFrameTimes()) + "," +
+        timingJson("showUs", getShowTimes()) + "," +
+        timingJson("webUs", webTimes) + "," + streamJson + "}";
+}
+
+void countLoop() {
+    loopIterations++;
+}
+
+
+/* WEB SITE CODE */
+// the page itself is web/index.html, built into IndexPage.h
 
 void startWebServer() {
-    // Route for root / web page
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
-        request->send_P(200, "text/html", index_html, processor);
-    });
+    ws.onEvent(onControlSocketEvent);
+    server.addHandler(&ws);
+
+    // Route for root / web page, sent as it is in flash, already gzipped.
+    // It never changes until the firmware does, so the browser can keep
+    // it and only ask whether its copy is still current
+    server.on("/", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+        if (request->hasHeader("If-None-Match") &&
+            request->getHeader("If-None-Match")->value() == IndexPageETag) {
+            request->send(304);
+            return;
+        }
+        AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", IndexPage, IndexPageSize);
+        response->addHeader("Content-Encoding", "gzip");
+        response->addHeader("ETag", IndexPageETag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+    }));
+
+    // Send a GET request to <ESP_IP>/state for what the page shows as JSON,
+    // the control socket sends the same whenever it changes
+    server.on("/state", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+        request->send(200, "application/json", stateJson(true));
+    }));
+
+    // Send a GET request to <ESP_IP>/metrics for how the mirror is keeping
+    // up: frame rate, frame, strip and request times, and the heap
+    server.on("/metrics", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+        request->send(200, "application/json", metricsJson());
+    }));
     
     // Send a GET request to <ESP_IP>/update?output=<inputMessage1>&state=<inputMessage2>
     server.on(
-        "/update", HTTP_GET, [] (AsyncWebServerRequest *request) {
+        "/update", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
             String inputMessage1;
             String inputMessage2;
             
@@ -91,13 +292,15 @@ void startWebServer() {
                 inputMessage1 = request->getParam(PARAM_INPUT_1)->value();
                 inputMessage2 = request->getParam(PARAM_INPUT_2)->value();
                 // // Turn off Animations
-                if (inputMessage2.toInt() == 0){
-                    selectedAnimation = 0;
+                int animation = (inputMessage2.toInt() == 0) ? 0 : inputMessage1.toInt();
+                if (!isValidCommand(Command_SetEffect, animation)) {
+                    request->send(400, "text/plain", "No such effect");
+                    return;
                 }
-                else {
-                    selectedAnimation = inputMessage1.toInt();
+                if (!postCommand(Command_SetEffect, animation)) {
+                    request->send(503, "text/plain", "Busy");
+                    return;
                 }
-                
             }
 
             else {
@@ -106,11 +309,198 @@ void startWebServer() {
             }
 
             request->send(200, "text/plain", "OK");
-        }
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/strip?pins=5,6&counts=300,300 to split the
+    // pixels over several data pins, each strip gets its own RMT channel.
+    // The layout is saved and the controller restarts to use it.
+    // Without parameters it returns the layout in use.
+    server.on(
+        "/strip", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            if (!request->hasParam("pins") || !request->hasParam("counts")) {
+                request->send(200, "text/plain", layoutText(getStripLayout()));
+                return;
+            }
+
+            long pins[MaxStripSegments];
+            long counts[MaxStripSegments];
+            uint8_t pinCount = parseList(request->getParam("pins")->value(), pins, MaxStripSegments);
+            uint8_t countCount = parseList(request->getParam("counts")->value(), counts, MaxStripSegments);
+
+            StripLayout layout;
+            layout.segmentCount = (pinCount == countCount && pinCount <= MaxStripSegments) ? pinCount : 0;
+            for (uint8_t segment = 0; segment < layout.segmentCount; segment++) {
+                // checked before they are narrowed, so 65536 isn't taken as 0
+                if (counts[segment] < 1 || counts[segment] > MaxPixelCount) {
+                    request->send(400, "text/plain", "Counts must be 1 to " + String(MaxPixelCount));
+                    return;
+                }
+                if (pins[segment] < 0 || pins[segment] > 255) {
+                    layout.segmentCount = 0;
+                    break;
+                }
+                layout.segments[segment].pin = pins[segment];
+                layout.segments[segment].count = counts[segment];
+            }
+
+            if (!isValidLayout(layout)) {
+                request->send(400, "text/plain", "Invalid layout");
+                return;
+            }
+            // saved from loop() once the render task has taken it, never here
+            if (!setStripLayout(layout)) {
+                request->send(503, "text/plain", "Busy");
+                return;
+            }
+            request->send(200, "text/plain", "OK, restarting");
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/output?gamma=2.2&brightness=128&white=255,230,200&dither=1
+    // to change how every effect is shown, any of them can be left out.
+    // It replies with the settings in use afterwards.
+    server.on(
+        "/output", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            OutputSettings settings = getOutputSettings();
+
+            if (request->hasParam("gamma")) {
+                float gamma = request->getParam("gamma")->value().toFloat();
+                if (gamma < 0.1f || gamma > 5.0f) {
+                    request->send(400, "text/plain", "Gamma must be 0.1 to 5.0");
+                    return;
+                }
+                settings.gamma = gamma;
+            }
+            if (request->hasParam("brightness")) {
+                long brightness = request->getParam("brightness")->value().toInt();
+                if (brightness < 0 || brightness > 255) {
+                    request->send(400, "text/plain", "Brightness must be 0 to 255");
+                    return;
+                }
+                settings.brightness = brightness;
+            }
+            if (request->hasParam("white")) {
+                long white[3];
+                if (parseList(request->getParam("white")->value(), white, 3) != 3 ||
+                    white[0] < 0 || white[0] > 255 || white[1] < 0 || white[1] > 255 ||
+                    white[2] < 0 || white[2] > 255) {
+                    request->send(400, "text/plain", "White must be three values 0 to 255");
+                    return;
+                }
+                settings.whiteBalance = RgbColor(white[0], white[1], white[2]);
+            }
+            if (request->hasParam("dither")) {
+                settings.dither = request->getParam("dither")->value().toInt() != 0;
+            }
+
+            // the render task applies them together before its next frame
+            const OutputSettings current = getOutputSettings();
+            bool posted = true;
+            if (settings.gamma != current.gamma) {
+                posted &= postCommand(Command_SetGamma, (uint32_t)(settings.gamma * 1000.0f + 0.5f));
+            }
+            if (settings.brightness != current.brightness) {
+                posted &= postCommand(Command_SetBrightness, settings.brightness);
+            }
+            if (settings.whiteBalance != current.whiteBalance) {
+                posted &= postCommand(Command_SetWhiteBalance, packColour(settings.whiteBalance));
+            }
+            if (settings.dither != current.dither) {
+                posted &= postCommand(Command_SetDither, settings.dither ? 1 : 0);
+            }
+            if (!posted) {
+                request->send(503, "text/plain", "Busy");
+                return;
+            }
+            request->send(200, "text/plain", outputText(settings));
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/transition?ms=<0 to 10000> to set how long
+    // switching effects cross fades for, 0 switches straight over
+    server.on(
+        "/transition", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            if (request->hasParam("ms")) {
+                long duration = request->getParam("ms")->value().toInt();
+                if (duration < 0 || duration > 10000) {
+                    request->send(400, "text/plain", "Transition must be 0 to 10000 ms");
+                    return;
+                }
+                if (!postCommand(Command_SetTransition, duration)) {
+                    request->send(503, "text/plain", "Busy");
+                    return;
+                }
+                request->send(200, "text/plain", "ms=" + String(duration));
+                return;
+            }
+            request->send(200, "text/plain", "ms=" + String(getTransitionTime()));
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/colour?rgb=ff0000 to change the colour
+    // of the Bounce eye
+    server.on(
+        "/colour", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            if (!request->hasParam("rgb")) {
+                request->send(400, "text/plain", "rgb=RRGGBB required");
+                return;
+            }
+            String rgb = request->getParam("rgb")->value();
+            char* end = NULL;
+            uint32_t colour = strtoul(rgb.c_str(), &end, 16);
+            if (rgb.length() != 6 || *end != '\0') {
+                request->send(400, "text/plain", "rgb must be six hex digits");
+                return;
+            }
+            if (!postCommand(Command_SetColour, colour)) {
+                request->send(503, "text/plain", "Busy");
+                return;
+            }
+            request->send(200, "text/plain", "OK");
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/speed?percent=<0 to 1000> to run every
+    // effect slower or faster, 100 is normal and 0 pauses them
+    server.on(
+        "/speed", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            if (request->hasParam("percent")) {
+                long percent = request->getParam("percent")->value().toInt();
+                if (percent < 0 || percent > 1000) {
+                    request->send(400, "text/plain", "Speed must be 0 to 1000 percent");
+                    return;
+                }
+                if (!postCommand(Command_SetSpeed, percent)) {
+                    request->send(503, "text/plain", "Busy");
+                    return;
+                }
+                request->send(200, "text/plain", "percent=" + String(percent));
+                return;
+            }
+            request->send(200, "text/plain", "percent=" + String(getEffectSpeed()));
+        })
+    );
+
+    // Send a GET request to <ESP_IP>/effectspeed?percent=<0 to 1000> to run
+    // the selected effect slower or faster on top of /speed, 100 is normal
+    server.on(
+        "/effectspeed", HTTP_GET, timed([] (AsyncWebServerRequest *request) {
+            if (request->hasParam("percent")) {
+                long percent = request->getParam("percent")->value().toInt();
+                if (percent < 0 || percent > 1000) {
+                    request->send(400, "text/plain", "Speed must be 0 to 1000 percent");
+                    return;
+                }
+                if (!postCommand(Command_SetEffectSpeed, percent)) {
+                    request->send(503, "text/plain", "Busy");
+                    return;
+                }
+                request->send(200, "text/plain", "percent=" + String(percent));
+                return;
+            }
+            request->send(200, "text/plain", "percent=" + String(getEffectSpeed(getSelectedEffect())));
+        })
     );
     server.begin();
 }
-
-int getAnimation(){
-    return selectedAnimation;
-}
\ No newline at end of file
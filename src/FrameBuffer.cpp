@@ -0,0 +1,109 @@
+#include <FrameBuffer.h>
+#include <ColorMath.h>
+#include <algorithm>
+
+FrameBuffer::FrameBuffer(uint16_t* channels, uint16_t count) :
+    _channels(channels),
+    _count(count),
+    _offset(0),
+    _dirty(false) {
+}
+
+void FrameBuffer::Fill(const FrameColor& color, uint16_t first, uint16_t count) {
+    if (first >= _count) {
+        return;
+    }
+    if (count > _count - first) {
+        count = _count - first;
+    }
+
+    uint16_t* channels = _channels + first * ChannelsPerPixel;
+    uint16_t* end = channels + count * ChannelsPerPixel;
+    _dirty = true;
+
+    // encode the colour once in wire order
+    uint16_t encoded[ChannelsPerPixel];
+    encoded[Red] = color.R;
+    encoded[Green] = color.G;
+    encoded[Blue] = color.B;
+
+    // one channel if it doesn't start on a word boundary, the S2 can't
+    // store unaligned words
+    uint8_t phase = 0;
+    if (((uintptr_t)channels & 3) != 0 && channels < end) {
+        *channels++ = encoded[phase];
+        phase = 1;
+    }
+
+    // two pixels fit exactly in three words, so build them once starting
+    // from whichever channel of the pixel we are at and store whole words
+    // (both the S2 and the host are little endian)
+    ChannelPair words[3];
+    for (uint8_t index = 0; index < 3; index++) {
+        words[index] = encoded[(phase + index * 2) % 3] | ((uint32_t)encoded[(phase + index * 2 + 1) % 3] << 16);
+    }
+    ChannelPair* wordPixels = reinterpret_cast<ChannelPair*>(channels);
+    while (end - reinterpret_cast<uint16_t*>(wordPixels) >= 6) {
+        wordPixels[0] = words[0];
+        wordPixels[1] = words[1];
+        wordPixels[2] = words[2];
+        wordPixels += 3;
+    }
+
+    // and whatever is left over
+    channels = reinterpret_cast<uint16_t*>(wordPixels);
+    while (channels < end) {
+        *channels++ = encoded[phase];
+        phase = (phase == 2) ? 0 : phase + 1;
+    }
+}
+
+void FrameBuffer::Darken(uint16_t darkenBy) {
+    // colour order doesn't matter when every channel drops by the same amount
+    DarkenChannels(_channels, ChannelCount(), darkenBy);
+    _dirty = true;
+}
+
+void FrameBuffer::RotateRight(uint16_t rotationCount) {
+    if (_count == 0) {
+        return;
+    }
+    _offset = (_offset + rotationCount % _count) % _count;
+    _dirty = true;
+}
+
+void FrameBuffer::RotateLeft(uint16_t rotationCount) {
+    if (_count == 0) {
+        return;
+    }
+    _offset = (_offset + _count - rotationCount % _count) % _count;
+    _dirty = true;
+}
+
+void FrameBuffer::Normalise() {
+    if (_offset == 0) {
+        return;
+    }
+    // the last _offset pixels wrap round to the start of the strip
+    std::rotate(_channels, _channels + (_count - _offset) * ChannelsPerPixel, _channels + ChannelCount());
+    _offset = 0;
+}
+
+void FrameBuffer::CopyFrom(const FrameBuffer& other) {
+    if (other._count != _count) {
+        return;
+    }
+    memcpy(_channels, other._channels, ChannelCount() * sizeof(uint16_t));
+    _offset = other._offset;
+    _dirty = true;
+}
+
+void FrameBuffer::BlendToward(const FrameBuffer& other, uint32_t weight) {
+    if (other._count != _count || _offset != 0 || other._offset != 0) {
+        return;
+    }
+    for (size_t index = 0; index < ChannelCount(); index++) {
+        _channels[index] = BlendChannel(_channels[index], other._channels[index], weight);
+    }
+    _dirty = true;
+}
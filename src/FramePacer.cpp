@@ -0,0 +1,49 @@
+#include <FramePacer.h>
+
+FramePacer::FramePacer(uint16_t targetFps) :
+    _deadline(0),
+    _dropped(0),
+    _started(false) {
+    setTargetFps(targetFps);
+}
+
+void FramePacer::setTargetFps(uint16_t targetFps) {
+    if (targetFps == 0) {
+        targetFps = 1;
+    }
+    _targetFps = targetFps;
+    _interval = 1000000UL / targetFps;
+}
+
+uint16_t FramePacer::getTargetFps() const {
+    return _targetFps;
+}
+
+uint32_t FramePacer::timeUntilDue(uint32_t nowMicros) const {
+    if (!_started) {
+        return 0;
+    }
+    // signed difference so the micros() wrap doesn't matter
+    int32_t remaining = (int32_t)(_deadline - nowMicros);
+    return (remaining > 0) ? remaining : 0;
+}
+
+void FramePacer::frameStarted(uint32_t nowMicros) {
+    if (!_started) {
+        _deadline = nowMicros;
+        _started = true;
+    }
+
+    int32_t late = (int32_t)(nowMicros - _deadline);
+    if (late >= (int32_t)_interval) {
+        // we missed whole frames, skip them and stay on the grid
+        uint32_t missed = late / _interval;
+        _dropped += missed;
+        _deadline += missed * _interval;
+    }
+    _deadline += _interval;
+}
+
+uint32_t FramePacer::getDroppedFrames() const {
+    return _dropped;
+}
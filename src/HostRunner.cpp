@@ -0,0 +1,58 @@
+// Host driver for the native environment, runs the effects against the
+// simulated strip and virtual clock so they can be profiled on Linux.
+//
+//   .pio/build/native/program [animation] [frames] [frame ms] [seed]
+//
+// animation 1 and up picks an effect, 0 runs all of them one after
+// another. The same seed always draws the same frames.
+#include <LEDController.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef PIO_UNIT_TESTING
+
+static void runAnimation(int animation, uint32_t frames, uint32_t frameMs) {
+    uint32_t sentBefore = getFrameCounters().sent;
+    uint32_t skippedBefore = getFrameCounters().skipped;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        hostAdvanceMillis(frameMs);
+        animationSelector(animation);
+        showFrame();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    printf("animation %d: %u frames, %u shows, %u skipped, %.1f ns/frame\n",
+        animation, frames, getFrameCounters().sent - sentBefore,
+        getFrameCounters().skipped - skippedBefore, ns / frames);
+}
+
+int main(int argc, char** argv) {
+    int animation = (argc > 1) ? atoi(argv[1]) : 0;
+    uint32_t frames = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 1000000;
+    uint32_t frameMs = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 16;
+    uint32_t seed = (argc > 4) ? strtoul(argv[4], nullptr, 10) : 1;
+
+    initStrip();
+    SetRandomSeed(seed);
+    changeCylonColour(HtmlColor(0x7f0000));
+
+    if (animation != 0) {
+        runAnimation(animation, frames, frameMs);
+        return 0;
+    }
+
+    // every effect in the registry after Off, the stream's slot isn't one
+    for (animation = 1; animation < getEffectCount(); animation++) {
+        // turn off in between so every effect starts from a dark strip
+        animationSelector(0);
+        runAnimation(animation, frames, frameMs);
+    }
+    return 0;
+}
+
+#endif
@@ -1,460 +1,1076 @@
 #include <LEDController.h>
+#include <EffectEngine.h>
+#include <FrameBuffer.h>
+#include <SavedState.h>
 
 // NeoPixel Setup
-const uint16_t PixelCount = 45; // make sure to set this to the number of pixels in your strip
-const uint16_t PixelPin = 5;  // make sure to set this to the correct pin, ignored for Esp8266
-NeoPixelBus<NeoGrbFeature, NeoWs2812xMethod> strip(PixelCount, PixelPin);
+#ifndef LED_PIXEL_COUNT
+#if LED_FIXED_PIXEL_COUNT
+#define LED_PIXEL_COUNT LED_FIXED_PIXEL_COUNT
+#else
+#define LED_PIXEL_COUNT 45
+#endif
+#endif
+// used until a layout is saved with setStripLayout()
+const uint16_t DefaultPixelCount = LED_PIXEL_COUNT; // make sure to set this to the number of pixels in your strip
+const uint8_t DefaultPixelPin = 5;  // make sure to set this to the correct pin, ignored for Esp8266
+
+StripLayout stripLayout = { 1, { { DefaultPixelPin, DefaultPixelCount } } };
+StripOutput stripOutput;
+OutputStage outputStage;
+
+// the curve NeoGammaTableMethod corrects with
+const float DefaultGamma = 1.0f / 0.45f;
+OutputSettings outputSettings = { DefaultGamma, 255, RgbColor(255, 255, 255), true };
+bool outputSettingsChanged = true;
+#if LED_FIXED_PIXEL_COUNT
+// a fixed installation, so every loop over the strip has a constant bound
+const uint16_t PixelCount = Strip::PixelCount;
+#else
+uint16_t PixelCount = 0; // total of every segment, set once by initStrip()
+#endif
+
+void setUpEffects();
+void restoreState();
 
 // Initialise Strip
 void initStrip(){
     SetRandomSeed();
-    strip.Begin();
-    strip.Show();
+    loadStripLayout(stripLayout);
+    // before anything is sent, so the first frame is already the saved one
+    restoreState();
+    stripOutput.Begin(stripLayout);
+#if !LED_FIXED_PIXEL_COUNT
+    PixelCount = stripOutput.PixelCount();
+#endif
+    setUpEffects();
 }
 
 void SetRandomSeed() {
-    uint32_t seed;
+    // the hardware RNG gives a full 32 bits straight away, where reading a
+    // floating pin gave a few bits a ms. Until the radio is up it draws on
+    // less noise, which is still far more than the effects need
+    SetRandomSeed(esp_random());
+}
 
-    // random works best with a seed that can use 31 bits
-    // analogRead on a unconnected pin tends toward less than four bits
-    seed = analogRead(16);
-    delay(1);
+void SetRandomSeed(uint32_t seed) {
+    effectRandom.Seed(seed);
+}
 
-    for (int shifts = 3; shifts < 31; shifts += 3)
-    {
-        seed ^= analogRead(16) << shifts;
-        delay(1);
+uint16_t getPixelCount() {
+    return PixelCount;
+}
+
+StripLayout getStripLayout() {
+    return stripLayout;
+}
+
+// A layout from the web server goes to the render task as a command, then
+// to loop() to be saved. Only the web server writes requestedLayout, and
+// only while no request is under way, so each side reads it whole.
+enum LayoutRequest : uint8_t {
+    Layout_None,
+    Layout_Posted,   // web server, queued for the render task
+    Layout_Taken,    // render task, waiting for loop() to save it
+    Layout_Saved     // loop(), waiting for the restart
+};
+StripLayout requestedLayout;
+std::atomic<uint8_t> layoutRequest(Layout_None);
+
+bool setStripLayout(const StripLayout& layout) {
+    if (!isValidLayout(layout) || layoutRequest.load() != Layout_None) {
+        return false;
+    }
+    requestedLayout = layout;
+    layoutRequest.store(Layout_Posted);
+    if (!postCommand(Command_SetLayout, 0)) {
+        layoutRequest.store(Layout_None);
+        return false;
     }
+    return true;
+}
+
+bool saveRequestedLayout() {
+    if (layoutRequest.load() != Layout_Taken) {
+        return false;
+    }
+    // the frame and effect state are sized at boot, so it takes a restart
+    if (!saveStripLayout(requestedLayout)) {
+        layoutRequest.store(Layout_None);
+        return false;
+    }
+    layoutRequest.store(Layout_Saved);
+    return true;
+}
+
+OutputSettings getOutputSettings() {
+    return outputSettings;
+}
+
+void setOutputSettings(const OutputSettings& settings) {
+    // picked up by the next showFrame(), so the tables are never rebuilt
+    // part way through sending a frame
+    outputSettings = settings;
+    outputSettingsChanged = true;
+}
+
+
+/* PIXEL BUFFER HELPERS */
+// what the effects draw into, the strip only sees it when a frame is sent
+FrameBuffer frame(NULL, 0);
 
-    // Serial.println(seed);
-    randomSeed(seed);
+void fillPixels(const FrameColor& color, uint16_t first, uint16_t count) {
+    frame.Fill(color, first, count);
+}
+
+void darkenPixels(uint8_t darkenBy) {
+    // the same step as an 8 bit colour, the tail just keeps its precision
+    frame.Darken(darkenBy * 257);
+}
+
+const FrameBuffer& getFrame() {
+    return frame;
 }
 
 
 /* ANIMATION 1 - BASIC ANIMATION */
-NeoPixelAnimator basicAnimations(PixelCount, NEO_CENTISECONDS);
-
-void SetupAnimationSet() {
-    // setup some animations
-    for (uint16_t pixel = 0; pixel < PixelCount; pixel++) {
-        const uint8_t peak = 128;
-
-        // pick a random duration of the animation for this pixel
-        // since values are centiseconds, the range is 1 - 4 seconds
-        uint16_t time = random(100, 400);
-
-        // each animation starts with the color that was present
-        RgbColor originalColor = strip.GetPixelColor<RgbColor>(pixel);
-        // and ends with a random color
-        RgbColor targetColor = RgbColor(random(peak), random(peak), random(peak));
-        // with the random ease function
-        AnimEaseFunction easing;
-
-        switch (random(3)) {
-        case 0:
-            easing = NeoEase::CubicIn;
-            break;
-        case 1:
-            easing = NeoEase::CubicOut;
-            break;
-        case 2:
-            easing = NeoEase::QuadraticInOut;
-            break;
-        }
-        // we must supply a function that will define the animation, in this example
-        // we are using "lambda expression" to define the function inline, which gives
-        // us an easy way to "capture" the originalColor and targetColor for the call back.
-        //
-        // this function will get called back when ever the animation needs to change
-        // the state of the pixel, it will provide a animation progress value
-        // from 0.0 (start of animation) to 1.0 (end of animation)
-        //
-        // we use this progress value to define how we want to animate in this case
-        // we call RgbColor::LinearBlend which will return a color blended between
-        // the values given, by the amount passed, which is also a float value from 0.0-1.0.
-        // then we set the color.
-        //
-        // There is no need for the MyAnimationState struct as the compiler takes care
-        // of those details for us
-        AnimUpdateCallback animUpdate = [=](const AnimationParam& param) {
-            // progress will start at 0.0 and end at 1.0
-            // we convert to the curve we want
-            float progress = easing(param.progress);
-
-            // use the curve value to apply to the animation
-            RgbColor updatedColor = RgbColor::LinearBlend(originalColor, targetColor, progress);
-            strip.SetPixelColor(pixel, updatedColor);
-        };
-
-        // now use the animation properties we just calculated and start the animation
-        // which will continue to run and call the update function until it completes
-        basicAnimations.StartAnimation(pixel, time, animUpdate);
+// the ease functions a pixel can pick from
+EaseTable easeCubicIn(NeoEase::CubicIn);
+EaseTable easeCubicOut(NeoEase::CubicOut);
+EaseTable easeQuadraticInOut(NeoEase::QuadraticInOut);
+
+// each pixel blends from the color it had to a random one along its own curve
+struct BasicAnimationState {
+    FrameColor StartingColor;
+    FrameColor EndingColor;
+    const EaseTable* Easing;
+};
+
+class BasicAnimation : public Effect {
+public:
+    BasicAnimation(EffectArena& arena) :
+        basicAnimations(arena, this, PixelCount, NEO_CENTISECONDS),
+        basicAnimationState(arena.Allocate<BasicAnimationState>(PixelCount)) {
+    }
+
+    void Update() override {
+        if (basicAnimations.IsAnimating()) {
+            basicAnimations.UpdateAnimations();
+        }
+        else {
+            SetupAnimationSet();
+        }
     }
-}
 
+    static constexpr size_t StateSize(uint16_t pixelCount) {
+        return EffectAnimator::ArenaSize(pixelCount) +
+            sizeof(BasicAnimationState) * pixelCount + alignof(BasicAnimationState);
+    }
 
-/* ANIMATION 2 - FADE IN FADE OUT */
-NeoPixelAnimator fadeInFadeOutAnimations(1); // NeoPixel animation management object
-boolean fadeToColor = true;  // general purpose variable used to store effect state
+private:
+    // this function will get called back when ever the animation needs to change
+    // the state of the pixel, it will provide a animation progress value
+    // from 0 (start of animation) to Q16One (end of animation)
+    //
+    // the animation index is the pixel, so the colors and curve are looked up
+    // in the state kept for it rather than captured in a lambda, which would
+    // allocate for every pixel each time the set restarts
+    static void BlendAnimUpdate(void* context, const EffectParam& param) {
+        const BasicAnimationState& state = static_cast<BasicAnimation*>(context)->basicAnimationState[param.index];
+
+        // progress will start at 0 and end at Q16One
+        // we convert to the curve we want
+        uint32_t progress = state.Easing->Ease(param.progress);
+
+        // use the curve value to apply to the animation
+        FrameColor updatedColor = BlendColor(state.StartingColor, state.EndingColor, progress);
+        frame.SetPixelColor(param.index, updatedColor);
+    }
+
+    void SetupAnimationSet() {
+        // setup some animations
+        for (uint16_t pixel = 0; pixel < PixelCount; pixel++) {
+            const uint8_t peak = 128;
+            BasicAnimationState& state = basicAnimationState[pixel];
+
+            // pick a random duration of the animation for this pixel
+            // since values are centiseconds, the range is 1 - 4 seconds
+            uint16_t time = effectRandom.Between(100, 400);
+
+            // each animation starts with the color that was present
+            state.StartingColor = frame.GetPixelColor16(pixel);
+            // and ends with a random color
+            state.EndingColor = RgbColor(effectRandom.Below(peak), effectRandom.Below(peak), effectRandom.Below(peak));
+            // with the random ease function
+            switch (effectRandom.Below(3)) {
+            case 0:
+                state.Easing = &easeCubicIn;
+                break;
+            case 1:
+                state.Easing = &easeCubicOut;
+                break;
+            default:
+                state.Easing = &easeQuadraticInOut;
+                break;
+            }
+
+            // now use the animation properties we just calculated and start the animation
+            // which will continue to run and call the update function until it completes
+            basicAnimations.StartAnimation(pixel, time, BlendAnimUpdate);
+        }
+    }
+
+    EffectAnimator basicAnimations;
+    BasicAnimationState* basicAnimationState;
+};
 
+
+/* ANIMATION 2 - FADE IN FADE OUT */
 // what is stored for state is specific to the need, in this case, the colors.
 // basically what ever you need inside the animation update function
 struct FadeInFadeOutAminationState {
-    RgbColor StartingColor;
-    RgbColor EndingColor;
+    FrameColor StartingColor;
+    FrameColor EndingColor;
 };
 
-// one entry per pixel to match the animation timing manager
-FadeInFadeOutAminationState fadeInFadeOutAnimationState[1];
-// simple blend function
-void SimpleBlendAnimUpdate(const AnimationParam& param) {
-    // this gets called for each animation on every time step
-    // progress will start at 0.0 and end at 1.0
-    // we use the blend function on the RgbColor to mix
-    // color based on the progress given to us in the animation
-    RgbColor updatedColor = RgbColor::LinearBlend(
-        fadeInFadeOutAnimationState[param.index].StartingColor,
-        fadeInFadeOutAnimationState[param.index].EndingColor,
-        param.progress
-    );
-
-    // apply the color to the strip
-    for (uint16_t pixel = 0; pixel < PixelCount; pixel++) {
-        strip.SetPixelColor(pixel, updatedColor);
+class FadeInFadeOutAnimation : public Effect {
+public:
+    FadeInFadeOutAnimation(EffectArena& arena) :
+        fadeInFadeOutAnimations(arena, this, 1),
+        fadeToColor(true) {
     }
-}
 
-void FadeInFadeOutRinseRepeat(float luminance) {
-    if (fadeToColor) {
-        // Fade upto a random color
-        // we use HslColor object as it allows us to easily pick a hue
-        // with the same saturation and luminance so the colors picked
-        // will have similiar overall brightness
-        RgbColor target = HslColor(random(360) / 360.0f, 1.0f, luminance);
-        uint16_t time = random(800, 2000);
+    void Update() override {
+        if (fadeInFadeOutAnimations.IsAnimating()) {
+            fadeInFadeOutAnimations.UpdateAnimations();
+        }
+        else {
+            // no animation runnning, start some
+            FadeInFadeOutRinseRepeat(0.2f); // 0.0 = black, 0.25 is normal, 0.5 is bright
+        }
+    }
 
-        fadeInFadeOutAnimationState[0].StartingColor = strip.GetPixelColor<RgbColor>(0);
-        fadeInFadeOutAnimationState[0].EndingColor = target;
+    static constexpr size_t StateSize(uint16_t) {
+        return EffectAnimator::ArenaSize(1);
+    }
 
-        fadeInFadeOutAnimations.StartAnimation(0, time, SimpleBlendAnimUpdate);
+private:
+    // simple blend function
+    static void SimpleBlendAnimUpdate(void* context, const EffectParam& param) {
+        const FadeInFadeOutAminationState* fadeInFadeOutAnimationState =
+            static_cast<FadeInFadeOutAnimation*>(context)->fadeInFadeOutAnimationState;
+
+        // this gets called for each animation on every time step
+        // progress will start at 0 and end at Q16One
+        // we use the integer blend function to mix
+        // color based on the progress given to us in the animation
+        FrameColor updatedColor = BlendColor(
+            fadeInFadeOutAnimationState[param.index].StartingColor,
+            fadeInFadeOutAnimationState[param.index].EndingColor,
+            param.progress
+        );
+
+        // apply the color to the whole strip
+        fillPixels(updatedColor, 0, PixelCount);
     }
-    else {
-        // fade to black
-        uint16_t time = random(600, 700);
 
-        fadeInFadeOutAnimationState[0].StartingColor = strip.GetPixelColor<RgbColor>(0);
-        fadeInFadeOutAnimationState[0].EndingColor = RgbColor(0);
+    void FadeInFadeOutRinseRepeat(float luminance) {
+        if (fadeToColor) {
+            // Fade upto a random color
+            // we use HslColor object as it allows us to easily pick a hue
+            // with the same saturation and luminance so the colors picked
+            // will have similiar overall brightness
+            RgbColor target = HslColor(effectRandom.Below(360) / 360.0f, 1.0f, luminance);
+            uint16_t time = effectRandom.Between(800, 2000);
+
+            fadeInFadeOutAnimationState[0].StartingColor = frame.GetPixelColor16(0);
+            fadeInFadeOutAnimationState[0].EndingColor = target;
 
-        fadeInFadeOutAnimations.StartAnimation(0, time, SimpleBlendAnimUpdate);
+            fadeInFadeOutAnimations.StartAnimation(0, time, SimpleBlendAnimUpdate);
+        }
+        else {
+            // fade to black
+            uint16_t time = effectRandom.Between(600, 700);
+
+            fadeInFadeOutAnimationState[0].StartingColor = frame.GetPixelColor16(0);
+            fadeInFadeOutAnimationState[0].EndingColor = RgbColor(0);
+
+            fadeInFadeOutAnimations.StartAnimation(0, time, SimpleBlendAnimUpdate);
+        }
+
+        // toggle to the next effect state
+        fadeToColor = !fadeToColor;
     }
 
-    // toggle to the next effect state
-    fadeToColor = !fadeToColor;
-}
+    EffectAnimator fadeInFadeOutAnimations; // NeoPixel animation management object
+    boolean fadeToColor;  // general purpose variable used to store effect state
+    // one entry per pixel to match the animation timing manager
+    FadeInFadeOutAminationState fadeInFadeOutAnimationState[1];
+};
 
 
 /* AMIMATION 3 - FUN RANDOM CHANGE */
-NeoPixelAnimator fRCAnimations(PixelCount);
-
 struct FRCAnimationState {
-    RgbColor StartingColor;
-    RgbColor EndingColor;
+    FrameColor StartingColor;
+    FrameColor EndingColor;
 };
 
-// one entry per pixel to match the animation timing manager
-FRCAnimationState fRCAnimationState[PixelCount];
+class RandomChangeAnimation : public Effect {
+public:
+    RandomChangeAnimation(EffectArena& arena) :
+        fRCAnimations(arena, this, PixelCount),
+        fRCAnimationState(arena.Allocate<FRCAnimationState>(PixelCount)) {
+    }
 
-// simple blend function
-void FRCBlendAnimUpdate(const AnimationParam& param) {
-    // this gets called for each animation on every time step
-    // progress will start at 0.0 and end at 1.0
-    // we use the blend function on the RgbColor to mix
-    // color based on the progress given to us in the animation
-    RgbColor updatedColor = RgbColor::LinearBlend(
-        fRCAnimationState[param.index].StartingColor,
-        fRCAnimationState[param.index].EndingColor,
-        param.progress);
-    // apply the color to the strip
-    strip.SetPixelColor(param.index, updatedColor);
-}
+    void Update() override {
+        if (fRCAnimations.IsAnimating()) {
+            fRCAnimations.UpdateAnimations();
+        }
+        else {
+            // no animations runnning, start some
+            PickRandom(0.2f); // 0.0 = black, 0.25 is normal, 0.5 is bright
+        }
+    }
 
-void PickRandom(float luminance){ 
-    // pick random count of pixels to animate
-    uint16_t count = random(PixelCount);
-    while (count > 0) {
-        // pick a random pixel
-        uint16_t pixel = random(PixelCount);
+    static constexpr size_t StateSize(uint16_t pixelCount) {
+        return EffectAnimator::ArenaSize(pixelCount) +
+            sizeof(FRCAnimationState) * pixelCount + alignof(FRCAnimationState);
+    }
 
-        // pick random time and random color
-        // we use HslColor object as it allows us to easily pick a color
-        // with the same saturation and luminance 
-        uint16_t time = random(100, 400);
-        fRCAnimationState[pixel].StartingColor = strip.GetPixelColor<RgbColor>(pixel);
-        fRCAnimationState[pixel].EndingColor = HslColor(random(360) / 360.0f, 1.0f, luminance);
+private:
+    // simple blend function
+    static void FRCBlendAnimUpdate(void* context, const EffectParam& param) {
+        const FRCAnimationState* fRCAnimationState = static_cast<RandomChangeAnimation*>(context)->fRCAnimationState;
+
+        // this gets called for each animation on every time step
+        // progress will start at 0 and end at Q16One
+        // we use the integer blend function to mix
+        // color based on the progress given to us in the animation
+        FrameColor updatedColor = BlendColor(
+            fRCAnimationState[param.index].StartingColor,
+            fRCAnimationState[param.index].EndingColor,
+            param.progress);
+        // apply the color to the strip
+        frame.SetPixelColor(param.index, updatedColor);
+    }
+
+    void PickRandom(float luminance){
+        // pick random count of pixels to animate
+        uint16_t count = effectRandom.Below(PixelCount);
+        while (count > 0) {
+            // pick a random pixel
+            uint16_t pixel = effectRandom.Below(PixelCount);
 
-        fRCAnimations.StartAnimation(pixel, time, FRCBlendAnimUpdate);
+            // pick random time and random color
+            // we use HslColor object as it allows us to easily pick a color
+            // with the same saturation and luminance
+            uint16_t time = effectRandom.Between(100, 400);
+            fRCAnimationState[pixel].StartingColor = frame.GetPixelColor16(pixel);
+            fRCAnimationState[pixel].EndingColor = RgbColor(HslColor(effectRandom.Below(360) / 360.0f, 1.0f, luminance));
 
-        count--;
+            fRCAnimations.StartAnimation(pixel, time, FRCBlendAnimUpdate);
+
+            count--;
+        }
     }
-}
+
+    EffectAnimator fRCAnimations;
+    // one entry per pixel to match the animation timing manager
+    FRCAnimationState* fRCAnimationState;
+};
 
 
 /* ANIMATION 4 - ROTATE LOOP */
 const uint16_t AnimCount = 1; // we only need one
 const uint16_t TailLength = 6; // length of the tail, must be shorter than PixelCount
 const float MaxLightness = 0.4f; // max lightness at the head of the tail (0.5f is full bright)
-NeoGamma<NeoGammaTableMethod> colorGamma; // for any fade animations, best to correct gamma
 
-NeoPixelAnimator rotateLoopAnimations(AnimCount); 
+class RotateLoopAnimation : public Effect {
+public:
+    RotateLoopAnimation(EffectArena& arena) :
+        rotateLoopAnimations(arena, this, AnimCount) {
+    }
+
+    void Update() override {
+        if (rotateLoopAnimations.IsAnimating()) {
+            rotateLoopAnimations.UpdateAnimations();
+        }
+        else {
+            // Draw the tail that will be rotated through all the rest of the pixels
+            DrawTailPixels();
+            // we use the index 0 animation to time how often we rotate all the pixels
+            rotateLoopAnimations.StartAnimation(0, 66, LoopAnimUpdate);
+        }
+    }
 
-void LoopAnimUpdate(const AnimationParam& param) {
-    // wait for this animation to complete,
-    // we are using it as a timer of sorts
-    if (param.state == AnimationState_Completed) {
-        // done, time to restart this position tracking animation/timer
-        rotateLoopAnimations.RestartAnimation(param.index);
+    static constexpr size_t StateSize(uint16_t) {
+        return EffectAnimator::ArenaSize(AnimCount);
+    }
 
-        // rotate the complete strip one pixel to the right on every update
-        strip.RotateRight(1);
+private:
+    static void LoopAnimUpdate(void* context, const EffectParam& param) {
+        // wait for this animation to complete,
+        // we are using it as a timer of sorts
+        if (param.state == AnimationState_Completed) {
+            // done, time to restart this position tracking animation/timer
+            static_cast<RotateLoopAnimation*>(context)->rotateLoopAnimations.RestartAnimation(param.index);
+
+            // rotate the complete strip one pixel to the right on every update,
+            // only the head index moves so this is the same at any length
+            frame.RotateRight(1);
+        }
     }
-}
 
-void DrawTailPixels() {
-    // using Hsl as it makes it easy to pick from similiar saturated colors
-    float hue = random(360) / 360.0f;
-    for (uint16_t index = 0; index < strip.PixelCount() && index <= TailLength; index++) {
-        float lightness = index * MaxLightness / TailLength;
-        RgbColor color = HslColor(hue, 1.0f, lightness);
-        strip.SetPixelColor(index, colorGamma.Correct(color));
+    void DrawTailPixels() {
+        // using Hsl as it makes it easy to pick from similiar saturated colors
+        float hue = effectRandom.Below(360) / 360.0f;
+        for (uint16_t index = 0; index < PixelCount && index <= TailLength; index++) {
+            float lightness = index * MaxLightness / TailLength;
+            RgbColor color = HslColor(hue, 1.0f, lightness);
+            frame.SetPixelColor(index, color);
+        }
     }
-}
+
+    EffectAnimator rotateLoopAnimations;
+};
 
 
 /* ANIMATION 5 - CYLON */
-NeoPixelAnimator cylonAnimations(2);
-uint16_t lastPixel = 0; // track the eye position
-int8_t moveDir = 1; // track the direction of movement
 // uncomment one of the lines below to see the effects of changing the ease function on the movement animation
-AnimEaseFunction moveEase =
-//      NeoEase::Linear;
-//      NeoEase::QuadraticInOut;
-//      NeoEase::CubicInOut;
-        NeoEase::QuarticInOut;
-//      NeoEase::QuinticInOut;
-//      NeoEase::SinusoidalInOut;
-//      NeoEase::ExponentialInOut;
-//      NeoEase::CircularInOut;
-
-RgbColor CylonEyeColor;
+EaseTable moveEase(
+//      NeoEase::Linear
+//      NeoEase::QuadraticInOut
+//      NeoEase::CubicInOut
+        NeoEase::QuarticInOut
+//      NeoEase::QuinticInOut
+//      NeoEase::SinusoidalInOut
+//      NeoEase::ExponentialInOut
+//      NeoEase::CircularInOut
+);
+
+RgbColor CylonEyeColor(0x7f, 0, 0); // red until one is chosen
 void changeCylonColour(RgbColor eyeColour) {
     CylonEyeColor = eyeColour;
 }
 
+RgbColor getCylonColour() {
+    return CylonEyeColor;
+}
+
 
-void FadeAll(uint8_t darkenBy) {
-    RgbColor color;
-    for (uint16_t indexPixel = 0; indexPixel < strip.PixelCount(); indexPixel++) {
-        color = strip.GetPixelColor<RgbColor>(indexPixel);
-        color.Darken(darkenBy);
-        strip.SetPixelColor(indexPixel, color);
+class CylonAnimation : public Effect {
+public:
+    CylonAnimation(EffectArena& arena) :
+        cylonAnimations(arena, this, 2),
+        lastPixel(0),
+        moveDir(1) {
     }
-}
 
-void FadeAnimUpdate(const AnimationParam& param) {
-    if (param.state == AnimationState_Completed) {
-        FadeAll(10);
-        cylonAnimations.RestartAnimation(param.index);
+    void Update() override {
+        if (cylonAnimations.IsAnimating()) {
+            cylonAnimations.UpdateAnimations();
+        }
+        else {
+            SetupCylonAnimations();
+        }
     }
-}
 
-void MoveAnimUpdate(const AnimationParam& param) {
-    // apply the movement animation curve
-    float progress = moveEase(param.progress);
+    static constexpr size_t StateSize(uint16_t) {
+        return EffectAnimator::ArenaSize(2);
+    }
 
-    // use the curved progress to calculate the pixel to effect
-    uint16_t nextPixel;
-    if (moveDir > 0) {
-        nextPixel = progress * strip.PixelCount();
+private:
+    static void FadeAnimUpdate(void* context, const EffectParam& param) {
+        if (param.state == AnimationState_Completed) {
+            darkenPixels(10);
+            static_cast<CylonAnimation*>(context)->cylonAnimations.RestartAnimation(param.index);
+        }
     }
-    else {
-        nextPixel = (1.0f - progress) * strip.PixelCount();
+
+    static void MoveAnimUpdate(void* context, const EffectParam& param) {
+        static_cast<CylonAnimation*>(context)->MoveEye(param);
     }
 
-    // if progress moves fast enough, we may move more than
-    // one pixel, so we update all between the calculated and
-    // the last
-    if (lastPixel != nextPixel) {
-        for (uint16_t i = lastPixel + moveDir; i != nextPixel; i += moveDir) {
-            strip.SetPixelColor(i, CylonEyeColor);
+    void MoveEye(const EffectParam& param) {
+        // apply the movement animation curve
+        uint32_t progress = moveEase.Ease(param.progress);
+
+        // use the curved progress to calculate the pixel to effect
+        uint16_t nextPixel;
+        if (moveDir > 0) {
+            nextPixel = (progress * PixelCount) >> 16;
         }
-    }
-    strip.SetPixelColor(nextPixel, CylonEyeColor);
+        else {
+            nextPixel = ((Q16One - progress) * PixelCount) >> 16;
+        }
+
+        // if progress moves fast enough, we may move more than
+        // one pixel, so we update all between the calculated and
+        // the last
+        if (lastPixel != nextPixel) {
+            for (uint16_t i = lastPixel + moveDir; i != nextPixel; i += moveDir) {
+                frame.SetPixelColor(i, CylonEyeColor);
+            }
+        }
+        frame.SetPixelColor(nextPixel, CylonEyeColor);
 
-    lastPixel = nextPixel;
+        lastPixel = nextPixel;
 
-    if (param.state == AnimationState_Completed) {
-        // reverse direction of movement
-        moveDir *= -1;
+        if (param.state == AnimationState_Completed) {
+            // reverse direction of movement
+            moveDir *= -1;
 
-        // done, time to restart this position tracking animation/timer
-        cylonAnimations.RestartAnimation(param.index);
+            // done, time to restart this position tracking animation/timer
+            cylonAnimations.RestartAnimation(param.index);
+        }
     }
-}
 
-void SetupCylonAnimations() {
-    // fade all pixels providing a tail that is longer the faster
-    // the pixel moves.
-    cylonAnimations.StartAnimation(0, 5, FadeAnimUpdate);
+    void SetupCylonAnimations() {
+        // fade all pixels providing a tail that is longer the faster
+        // the pixel moves.
+        cylonAnimations.StartAnimation(0, 5, FadeAnimUpdate);
 
-    // take several seconds to move eye fron one side to the other
-    cylonAnimations.StartAnimation(1, 2000, MoveAnimUpdate);
-}
+        // take several seconds to move eye fron one side to the other
+        cylonAnimations.StartAnimation(1, 2000, MoveAnimUpdate);
+    }
+
+    EffectAnimator cylonAnimations;
+    uint16_t lastPixel; // track the eye position
+    int8_t moveDir; // track the direction of movement
+};
 
 
 /* ANIMATION 6 - FUN ROTATE LOOP */
-const uint16_t FunLoopAnimCount = PixelCount / 5 * 2 + 1; // we only need enough animations for the tail and one extra
+// we only need enough animations for the tail and one extra
+constexpr uint16_t FunLoopAnimCount(uint16_t pixelCount) {
+    return pixelCount / 5 * 2 + 1;
+}
 const uint16_t FunLoopPixelFadeDuration = 300; // third of a second
-// one second divide by the number of pixels = loop once a second
-const uint16_t FunLoopNextPixelMoveDuration = 1000 / PixelCount; // how fast we move through the pixels
 
 struct FunLoopAnimationState {
-    RgbColor StartingColor;
-    RgbColor EndingColor;
+    FrameColor StartingColor;
+    FrameColor EndingColor;
     uint16_t IndexPixel; // which pixel this animation is effecting
 };
 
-NeoPixelAnimator funLoopAnimations(FunLoopAnimCount); // NeoPixel animation management object
-FunLoopAnimationState funLoopAnimationState[FunLoopAnimCount];
-uint16_t frontPixel = 0;  // the front of the loop
-RgbColor frontColor;  // the color at the front of the loop
+class FunLoopAnimation : public Effect {
+public:
+    FunLoopAnimation(EffectArena& arena) :
+        funLoopAnimations(arena, this, FunLoopAnimCount(PixelCount)), // NeoPixel animation management object
+        funLoopAnimationState(arena.Allocate<FunLoopAnimationState>(FunLoopAnimCount(PixelCount))),
+        // one second divide by the number of pixels = loop once a second
+        nextPixelMoveDuration(1000 / PixelCount), // how fast we move through the pixels
+        frontPixel(0) {
+    }
 
-void FadeOutAnimUpdate(const AnimationParam& param) {
-    // this gets called for each animation on every time step
-    // progress will start at 0.0 and end at 1.0
-    // we use the blend function on the RgbColor to mix
-    // color based on the progress given to us in the animation
-    RgbColor updatedColor = RgbColor::LinearBlend(
-        funLoopAnimationState[param.index].StartingColor,
-        funLoopAnimationState[param.index].EndingColor,
-        param.progress
-    );
-    // apply the color to the strip
-    strip.SetPixelColor(
-        funLoopAnimationState[param.index].IndexPixel, 
-        colorGamma.Correct(updatedColor)
-    );
-}
+    void Update() override {
+        if (funLoopAnimations.IsAnimating()) {
+            funLoopAnimations.UpdateAnimations();
+        }
+        else {
+            funLoopAnimations.StartAnimation(0, nextPixelMoveDuration, FunLoopAnimUpdate);
+        }
+    }
 
-void FunLoopAnimUpdate(const AnimationParam& param) {
-    // wait for this animation to complete,
-    // we are using it as a timer of sorts
-    if (param.state == AnimationState_Completed) {
-        // done, time to restart this position tracking animation/timer
-        funLoopAnimations.RestartAnimation(param.index);
+    static constexpr size_t StateSize(uint16_t pixelCount) {
+        return EffectAnimator::ArenaSize(FunLoopAnimCount(pixelCount)) +
+            sizeof(FunLoopAnimationState) * FunLoopAnimCount(pixelCount) + alignof(FunLoopAnimationState);
+    }
 
-        // pick the next pixel inline to start animating
-        // 
-        frontPixel = (frontPixel + 1) % PixelCount; // increment and wrap
-        if (frontPixel == 0) {
-            // we looped, lets pick a new front color
-            frontColor = HslColor(random(360) / 360.0f, 1.0f, 0.25f);
-        }
+private:
+    static void FadeOutAnimUpdate(void* context, const EffectParam& param) {
+        const FunLoopAnimationState* funLoopAnimationState = static_cast<FunLoopAnimation*>(context)->funLoopAnimationState;
+
+        // this gets called for each animation on every time step
+        // progress will start at 0 and end at Q16One
+        // we use the integer blend function to mix
+        // color based on the progress given to us in the animation
+        FrameColor updatedColor = BlendColor(
+            funLoopAnimationState[param.index].StartingColor,
+            funLoopAnimationState[param.index].EndingColor,
+            param.progress
+        );
+        // apply the color to the strip
+        frame.SetPixelColor(funLoopAnimationState[param.index].IndexPixel, updatedColor);
+    }
 
-        uint16_t indexAnim;
-        // do we have an animation available to use to animate the next front pixel?
-        // if you see skipping, then either you are going to fast or need to increase
-        // the number of animation channels
-        if (funLoopAnimations.NextAvailableAnimation(&indexAnim, 1)) {
-            funLoopAnimationState[indexAnim].StartingColor = frontColor;
-            funLoopAnimationState[indexAnim].EndingColor = RgbColor(0, 0, 0);
-            funLoopAnimationState[indexAnim].IndexPixel = frontPixel;
+    static void FunLoopAnimUpdate(void* context, const EffectParam& param) {
+        static_cast<FunLoopAnimation*>(context)->MoveFront(param);
+    }
 
-            funLoopAnimations.StartAnimation(indexAnim, FunLoopPixelFadeDuration, FadeOutAnimUpdate);
+    void MoveFront(const EffectParam& param) {
+        // wait for this animation to complete,
+        // we are using it as a timer of sorts
+        if (param.state == AnimationState_Completed) {
+            // done, time to restart this position tracking animation/timer
+            funLoopAnimations.RestartAnimation(param.index);
+
+            // pick the next pixel inline to start animating
+            //
+            frontPixel = (frontPixel + 1) % PixelCount; // increment and wrap
+            if (frontPixel == 0) {
+                // we looped, lets pick a new front color
+                frontColor = HslColor(effectRandom.Below(360) / 360.0f, 1.0f, 0.25f);
+            }
+
+            uint16_t indexAnim;
+            // do we have an animation available to use to animate the next front pixel?
+            // if you see skipping, then either you are going to fast or need to increase
+            // the number of animation channels
+            if (funLoopAnimations.NextAvailableAnimation(&indexAnim, 1)) {
+                funLoopAnimationState[indexAnim].StartingColor = frontColor;
+                funLoopAnimationState[indexAnim].EndingColor = RgbColor(0, 0, 0);
+                funLoopAnimationState[indexAnim].IndexPixel = frontPixel;
+
+                funLoopAnimations.StartAnimation(indexAnim, FunLoopPixelFadeDuration, FadeOutAnimUpdate);
+            }
         }
     }
+
+    EffectAnimator funLoopAnimations;
+    FunLoopAnimationState* funLoopAnimationState;
+    const uint16_t nextPixelMoveDuration;
+    uint16_t frontPixel;  // the front of the loop
+    RgbColor frontColor;  // the color at the front of the loop
+};
+
+
+
+/* EFFECT REGISTRY */
+// the position in this table is the animation number the web page selects, 0 is off
+const EffectEntry effects[] = {
+    { "Off", NULL },
+    { "Basic Pattern", CreateEffect<BasicAnimation> },
+    { "Fade In Fade Out", CreateEffect<FadeInFadeOutAnimation> },
+    { "Random Change", CreateEffect<RandomChangeAnimation> },
+    { "Rotating Loop", CreateEffect<RotateLoopAnimation> },
+    { "Bounce", CreateEffect<CylonAnimation> },
+    { "Fancy Rotating Loop", CreateEffect<FunLoopAnimation> },
+};
+const int EffectCount = sizeof(effects) / sizeof(effects[0]);
+static_assert(EffectCount <= SavedEffectCount, "SavedState has no room for every effect's speed");
+
+// percent of normal speed each effect runs at, on top of the speed of all
+// of them, set to 100 by restoreState() unless one was saved
+uint16_t effectSpeeds[EffectCount];
+
+constexpr size_t LargestOf(size_t a, size_t b) {
+    return (a > b) ? a : b;
+}
+
+EffectArena effectArena(NULL, 0);
+Effect* activeEffect = NULL;
+
+// the last picture of the effect being switched away from, the new effect
+// fades in over it. Only the pixels are kept, the old effect's state is
+// freed straight away so the arena still only ever holds one effect
+FrameBuffer outgoingFrame(NULL, 0);
+
+// frames from the network, shown in place of the effect while they arrive
+StreamReceiver streamReceiver;
+
+// the frame and effect state are sized for the layout once at boot and
+// kept, so switching effects never touches the heap
+void setUpEffects() {
+    // big enough for whichever effect needs the most state at this pixel count
+    const size_t arenaSize =
+        LargestOf(ArenaSizeFor<BasicAnimation>(PixelCount),
+        LargestOf(ArenaSizeFor<FadeInFadeOutAnimation>(PixelCount),
+        LargestOf(ArenaSizeFor<RandomChangeAnimation>(PixelCount),
+        LargestOf(ArenaSizeFor<RotateLoopAnimation>(PixelCount),
+        LargestOf(ArenaSizeFor<CylonAnimation>(PixelCount), ArenaSizeFor<FunLoopAnimation>(PixelCount))))));
+
+    // new[] is aligned for any type, which the arena relies on
+    effectArena = EffectArena(new uint8_t[arenaSize], arenaSize);
+    frame = FrameBuffer(new uint16_t[PixelCount * FrameBuffer::ChannelsPerPixel](), PixelCount);
+    outgoingFrame = FrameBuffer(new uint16_t[PixelCount * FrameBuffer::ChannelsPerPixel](), PixelCount);
+    outputStage.Begin(PixelCount);
+    streamReceiver.Begin(PixelCount);
+}
+
+int getEffectCount() {
+    return EffectCount;
+}
+
+const char* getEffectName(int animation) {
+    if (animation < 0 || animation >= EffectCount) {
+        return NULL;
+    }
+    return effects[animation].name;
 }
 
 
+/* TRANSITIONS */
+uint16_t transitionDuration = 500; // ms, 0 switches straight over
+uint32_t transitionStart = 0;
+uint32_t transitionWeight = Q16One; // Q16 share of the new effect, Q16One once it's done
+
+uint16_t getTransitionTime() {
+    return transitionDuration;
+}
+
+void setTransitionTime(uint16_t duration) {
+    transitionDuration = duration;
+}
+
+void startTransition() {
+    frame.Normalise();
+    if (transitionWeight < Q16One) {
+        // switched again part way through, fade from what is on the strip now
+        outgoingFrame.BlendToward(frame, transitionWeight);
+    }
+    else {
+        outgoingFrame.CopyFrom(frame);
+    }
+
+    // the new effect draws on black so only the fade mixes the two
+    fillPixels(RgbColor(0), 0, PixelCount);
+    transitionStart = millis();
+    transitionWeight = 0;
+}
+
+void updateTransition() {
+    if (transitionWeight >= Q16One) {
+        return;
+    }
+
+    uint32_t elapsed = millis() - transitionStart;
+    if (elapsed >= transitionDuration) {
+        transitionWeight = Q16One;
+        outputStage.SetTransition(NULL, Q16One);
+    }
+    else {
+        transitionWeight = (elapsed << 16) / transitionDuration;
+        outputStage.SetTransition(&outgoingFrame, transitionWeight);
+    }
+    // the blend changes every frame even if neither picture does
+    frame.Dirty();
+}
+
 
 /* ANIMATION SELECTOR FUNCTION */
+int lastAnimation = -1; // so the first call always sets up its effect
+// shown in place of the selected animation while the stream is live, so
+// switching to and from it cross fades like any other effect
+const int StreamAnimation = EffectCount;
+
+StreamReceiver& getStreamReceiver() {
+    return streamReceiver;
+}
+
 void animationSelector(int selectedAnimation) {
-    if (selectedAnimation == 0) {
-        // Stop All Animations before starting new one
-        basicAnimations.StopAll();
-        fadeInFadeOutAnimations.StopAll();
-        fRCAnimations.StopAll();
-        rotateLoopAnimations.StopAll();
-        cylonAnimations.StopAll();
-        funLoopAnimations.StopAll();
-        strip.ClearTo(HtmlColor(0x000000));
-        strip.Show();
-    }
-
-    else if (selectedAnimation == 1) {
-        if (basicAnimations.IsAnimating()) {
-            // the normal loop just needs these two to run the active animations
-            basicAnimations.UpdateAnimations();
-            strip.Show();
-        }
-        else {
-            SetupAnimationSet();
-        }
+    // one time for the whole frame, however long drawing it takes
+    const uint32_t now = millis();
+    effectClock.Advance(now);
+
+    const bool streaming = streamReceiver.IsActive(now);
+    if (streaming) {
+        selectedAnimation = StreamAnimation;
+    }
+    else if (lastAnimation == StreamAnimation) {
+        // anything still waiting is from before the stream stopped
+        streamReceiver.Flush();
     }
 
-    else if (selectedAnimation == 2) {
-        if (fadeInFadeOutAnimations.IsAnimating()) {
-            // the normal loop just needs these two to run the active animations
-            fadeInFadeOutAnimations.UpdateAnimations();
-            strip.Show();
-        }
-        else {
-            // no animation runnning, start some
-            FadeInFadeOutRinseRepeat(0.2f); // 0.0 = black, 0.25 is normal, 0.5 is bright
+    if (selectedAnimation != lastAnimation) {
+        // free the old effect before the new one is set up in its place
+        if (activeEffect != NULL) {
+            activeEffect->~Effect();
+            activeEffect = NULL;
         }
-    }
+        effectArena.Reset();
 
-    else if (selectedAnimation == 3) {
-        if (fRCAnimations.IsAnimating()) {
-            // the normal loop just needs these two to run the active animations
-            fRCAnimations.UpdateAnimations();
-            strip.Show();
+        if (transitionDuration > 0 && lastAnimation >= 0) {
+            startTransition();
         }
         else {
-            // no animations runnning, start some 
-            PickRandom(0.2f); // 0.0 = black, 0.25 is normal, 0.5 is bright
+            // the next effect starts from the picture as the strip shows it
+            frame.Normalise();
         }
-    }
-
-    else if (selectedAnimation == 4) {
-        if (rotateLoopAnimations.IsAnimating()) {
-            rotateLoopAnimations.UpdateAnimations();
-            strip.Show();
+        lastAnimation = selectedAnimation;
+        // show controllers send values already corrected for the strip,
+        // another curve on top would crush the low end
+        outputStage.SetGammaBypass(selectedAnimation == StreamAnimation);
+        // the stream isn't an effect, it keeps real time at the 100 the
+        // lookup gives anything outside the effects
+        effectClock.SetEffectSpeed(getEffectSpeed(selectedAnimation));
+
+        if (selectedAnimation > 0 && selectedAnimation < EffectCount) {
+            activeEffect = effects[selectedAnimation].create(effectArena);
         }
         else {
-            // Draw the tail that will be rotated through all the rest of the pixels
-            DrawTailPixels();
-            // we use the index 0 animation to time how often we rotate all the pixels
-            rotateLoopAnimations.StartAnimation(0, 66, LoopAnimUpdate); 
+            // turned off, clear once and there is nothing to draw after that
+            fillPixels(RgbColor(0), 0, PixelCount);
         }
     }
 
-    else if (selectedAnimation == 5) {
-        if (cylonAnimations.IsAnimating()) {
-            cylonAnimations.UpdateAnimations();
-            strip.Show();
+    if (streaming) {
+        streamReceiver.Exchange(frame, now);
+    }
+    else if (activeEffect != NULL) {
+        activeEffect->Update();
+    }
+    updateTransition();
+}
+
+
+/* COMMANDS */
+// big enough for a burst of slider moves between two frames
+const uint8_t CommandQueueSize = 32;
+CommandQueue<Command, CommandQueueSize> commandQueue;
+int selectedEffect = 0;
+volatile uint32_t stateVersion = 0;
+
+bool postCommand(CommandType type, uint32_t value) {
+    Command command = { type, value };
+    return commandQueue.Push(command);
+}
+
+void applyCommand(const Command& command) {
+    OutputSettings settings = outputSettings;
+    switch (command.type) {
+    case Command_SetEffect:
+        // the slot after the effects is the stream's, which only ever
+        // starts from a packet arriving
+        if (command.value < (uint32_t)getEffectCount()) {
+            selectedEffect = command.value;
         }
-        else {
-            SetupCylonAnimations();
+        return;
+    case Command_SetColour:
+        changeCylonColour(HtmlColor(command.value));
+        return;
+    case Command_SetSpeed:
+        setEffectSpeed(command.value);
+        return;
+    case Command_SetTransition:
+        setTransitionTime(command.value);
+        return;
+    case Command_SetEffectSpeed:
+        setEffectSpeed(selectedEffect, command.value);
+        return;
+    case Command_SetLayout:
+        // only used from the next boot, loop() saves it and restarts
+        if (layoutRequest.load() == Layout_Posted) {
+            layoutRequest.store(Layout_Taken);
         }
+        return;
+    case Command_SetBrightness:
+        settings.brightness = command.value;
+        break;
+    case Command_SetGamma:
+        settings.gamma = command.value / 1000.0f;
+        break;
+    case Command_SetWhiteBalance:
+        settings.whiteBalance = HtmlColor(command.value);
+        break;
+    case Command_SetDither:
+        settings.dither = command.value != 0;
+        break;
+    default:
+        return;
     }
+    setOutputSettings(settings);
+}
 
-    else if (selectedAnimation == 6){
-        if (funLoopAnimations.IsAnimating()) {
-            funLoopAnimations.UpdateAnimations();
-            strip.Show();
+void applyCommands() {
+    // at most a queue's worth, so a sender that keeps posting can't hold
+    // the frame up. They are applied in the order they were sent, so a
+    // speed sent for one effect can't land on the one selected after it,
+    // and of a run of the same type only the newest is applied
+    Command latest;
+    bool pending = false;
+    Command command;
+    for (uint8_t count = 0; count < CommandQueueSize && commandQueue.Pop(command); count++) {
+        if (command.type >= CommandTypeCount) {
+            continue;
         }
-        else {
-            funLoopAnimations.StartAnimation(0, FunLoopNextPixelMoveDuration, FunLoopAnimUpdate);
+        if (pending && command.type != latest.type) {
+            applyCommand(latest);
         }
+        latest = command;
+        pending = true;
+    }
+    if (!pending) {
+        return;
+    }
+
+    applyCommand(latest);
+    stateVersion++;
+}
+
+uint32_t getStateVersion() {
+    return stateVersion;
+}
+
+/* SAVED STATE */
+// how long the settings have to stay the same before they are saved, so
+// dragging a slider writes the flash once rather than every step
+const uint32_t SaveQuietPeriod = 5000; // ms
+SavedState savedState; // what NVS holds, so unchanged state isn't rewritten
+
+SavedState currentState() {
+    SavedState state;
+    memset(&state, 0, sizeof(state));
+    state.effect = selectedEffect;
+    state.brightness = outputSettings.brightness;
+    state.dither = outputSettings.dither ? 1 : 0;
+    state.colour = ((uint32_t)CylonEyeColor.R << 16) | ((uint32_t)CylonEyeColor.G << 8) | CylonEyeColor.B;
+    state.whiteBalance = ((uint32_t)outputSettings.whiteBalance.R << 16) |
+        ((uint32_t)outputSettings.whiteBalance.G << 8) | outputSettings.whiteBalance.B;
+    state.speed = effectClock.Speed();
+    state.transition = transitionDuration;
+    state.gamma = outputSettings.gamma;
+    for (int animation = 0; animation < EffectCount; animation++) {
+        state.effectSpeeds[animation] = effectSpeeds[animation];
+    }
+    return state;
+}
+
+void restoreState() {
+    for (int animation = 0; animation < EffectCount; animation++) {
+        effectSpeeds[animation] = 100;
+    }
+    savedState = currentState();
+    SavedState state;
+    if (!loadSavedState(state) || state.effect >= getEffectCount()) {
+        return;
+    }
+
+    selectedEffect = state.effect;
+    CylonEyeColor = HtmlColor(state.colour);
+    effectClock.SetSpeed(state.speed);
+    transitionDuration = state.transition;
+    outputSettings.brightness = state.brightness;
+    outputSettings.dither = state.dither != 0;
+    outputSettings.whiteBalance = HtmlColor(state.whiteBalance);
+    outputSettings.gamma = state.gamma;
+    for (int animation = 0; animation < EffectCount; animation++) {
+        effectSpeeds[animation] = state.effectSpeeds[animation];
+    }
+    outputSettingsChanged = true;
+    savedState = currentState();
+}
+
+void saveStateWhenQuiet() {
+    static uint32_t seenVersion = 0;
+    static uint32_t changedAt = 0;
+    static bool pending = false;
+
+    const uint32_t version = stateVersion;
+    if (version != seenVersion) {
+        seenVersion = version;
+        changedAt = millis();
+        pending = true;
+        return;
+    }
+    if (!pending || millis() - changedAt < SaveQuietPeriod) {
+        return;
+    }
+    pending = false;
+
+    // the render task only changes these when a command comes in, and
+    // none has for the quiet period
+    SavedState state = currentState();
+    if (memcmp(&state, &savedState, offsetof(SavedState, crc)) == 0) {
+        return;
     }
-}
\ No newline at end of file
+    if (saveSavedState(state)) {
+        savedState = state;
+    }
+}
+
+int getSelectedEffect() {
+    return selectedEffect;
+}
+
+uint16_t getEffectSpeed() {
+    return effectClock.Speed();
+}
+
+void setEffectSpeed(uint16_t percent) {
+    effectClock.SetSpeed(percent);
+}
+
+uint16_t getEffectSpeed(int animation) {
+    if (animation < 0 || animation >= EffectCount) {
+        return 100;
+    }
+    return effectSpeeds[animation];
+}
+
+void setEffectSpeed(int animation, uint16_t percent) {
+    if (animation < 0 || animation >= EffectCount) {
+        return;
+    }
+    effectSpeeds[animation] = percent;
+    // the clock just moves on at the new rate, so the animations carry on
+    // from where they are instead of being set up again
+    if (animation == lastAnimation) {
+        effectClock.SetEffectSpeed(percent);
+    }
+}
+
+
+/* FRAME OUTPUT */
+FrameCounters frameCounters = { 0, 0 };
+TimeHistogram showTimes;
+// how long a frame has to stand still before dithering stops, a second is
+// well past the few frames the fractions take to average out
+const uint8_t DitherSettleFrames = 60;
+uint8_t framesUnchanged = 0;
+
+bool showFrame() {
+    // effects only mark the frame dirty when they draw, so frames where
+    // every animation is waiting on a timer are rejected without a compare.
+    // effects often redraw pixels with the colour they already had, so
+    // each segment is also checked against what it last sent
+    bool dirty = frame.IsDirty();
+    frame.ResetDirty();
+    if (dirty) {
+        framesUnchanged = 0;
+    }
+    else if (framesUnchanged < DitherSettleFrames) {
+        framesUnchanged++;
+    }
+
+    // dithering moves the output on every frame, even when the frame
+    // doesn't, which is what smooths a fade. Once the frame has stood
+    // still for a while it is sent once more rounded and then left alone,
+    // so a still picture costs no more than with dithering off
+    if (outputSettings.dither) {
+        const bool settled = framesUnchanged >= DitherSettleFrames;
+        dirty |= !settled || !outputStage.DitherPaused();
+        outputStage.SetDitherPaused(settled);
+    }
+
+    // new settings change every pixel even if the frame didn't
+    if (outputSettingsChanged) {
+        outputSettingsChanged = false;
+        outputStage.SetSettings(outputSettings);
+        dirty = true;
+    }
+
+    if (!dirty) {
+        frameCounters.skipped++;
+        return false;
+    }
+
+    uint32_t showStart = micros();
+    bool sent = stripOutput.Show(frame, outputStage);
+    showTimes.Record(micros() - showStart);
+    if (!sent) {
+        frameCounters.skipped++;
+        return false;
+    }
+
+    frameCounters.sent++;
+    return true;
+}
+
+FrameCounters getFrameCounters() {
+    return frameCounters;
+}
+
+const TimeHistogram& getShowTimes() {
+    return showTimes;
+}
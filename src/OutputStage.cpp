@@ -0,0 +1,161 @@
+#include <OutputStage.h>
+
+OutputStage::OutputStage() :
+    _curveGamma(0.0f),
+    _gammaBypass(false),
+    _ditherPaused(false),
+    _carry(NULL),
+    _count(0),
+    _from(NULL),
+    _weight(0) {
+    OutputSettings linear = { 1.0f, 255, RgbColor(255, 255, 255), false };
+    SetSettings(linear);
+}
+
+void OutputStage::Begin(uint16_t count) {
+    if (_carry != NULL) {
+        return;
+    }
+    _count = count;
+    _carry = new uint8_t[count * Strip::BytesPerPixel];
+
+    // start every channel at a different point in its cycle, otherwise a
+    // whole strip of one colour would step up on the same frame together
+    for (size_t index = 0; index < (size_t)count * Strip::BytesPerPixel; index++) {
+        _carry[index] = (index * 159) & 0xff;
+    }
+}
+
+void OutputStage::SetSettings(const OutputSettings& settings) {
+    _settings = settings;
+    if (_settings.gamma <= 0.0f) {
+        _settings.gamma = 1.0f;
+    }
+
+    // the curve is the only part that needs powf, and it only changes with
+    // the gamma, so dragging the brightness or white balance costs integer
+    // multiplies only
+    if (_settings.gamma != _curveGamma) {
+        _curveGamma = _settings.gamma;
+        for (uint16_t step = 0; step < 256; step++) {
+            _curve[step] = (uint16_t)(powf(step / 255.0f, _curveGamma) * (255 << 8) + 0.5f);
+        }
+    }
+
+    buildTables();
+}
+
+void OutputStage::SetGammaBypass(bool bypass) {
+    if (bypass != _gammaBypass) {
+        _gammaBypass = bypass;
+        buildTables();
+    }
+}
+
+void OutputStage::buildTables() {
+    // which channel lands in each position of the pixel
+    uint8_t scales[FrameBuffer::ChannelsPerPixel];
+    scales[FrameBuffer::Red] = _settings.whiteBalance.R;
+    scales[FrameBuffer::Green] = _settings.whiteBalance.G;
+    scales[FrameBuffer::Blue] = _settings.whiteBalance.B;
+
+    for (uint8_t index = 0; index < FrameBuffer::ChannelsPerPixel; index++) {
+        // brightness times white balance as a Q16 fraction, full is Q16One,
+        // the curve tops out at 65280 so the product still fits
+        const uint32_t scale = ((uint32_t)_settings.brightness * scales[index] * Q16One + 65025 / 2) / 65025;
+        for (uint16_t step = 0; step < 256; step++) {
+            const uint32_t curve = _gammaBypass ? (uint32_t)step << 8 : _curve[step];
+            _tables[index][step] = (curve * scale + 0x8000) >> 16;
+        }
+        _tables[index][256] = _tables[index][255];
+    }
+}
+
+bool OutputStage::Apply(const FrameBuffer& frame, uint8_t* wire, uint16_t first, uint16_t count) {
+    // strip pixel p shows logical pixel p - offset, so any run of the strip
+    // is at most two runs of the frame, split where the logical pixels wrap
+    const uint8_t channelsPerPixel = FrameBuffer::ChannelsPerPixel;
+    const uint8_t bytesPerPixel = Strip::BytesPerPixel;
+    const uint16_t start = frame.LogicalIndex(first);
+    const uint16_t beforeWrap = (count < frame.PixelCount() - start) ? count : frame.PixelCount() - start;
+    const uint16_t* channels = frame.Channels();
+    uint8_t* carry = (_carry != NULL && first + count <= _count) ? _carry + first * bytesPerPixel : NULL;
+    // the frame being faded from is normalised, so it is in strip order
+    const uint16_t* from = (_from != NULL && _from->PixelCount() == frame.PixelCount()) ?
+        _from->Channels() + first * channelsPerPixel : NULL;
+
+    bool changed = applyRun(channels + start * channelsPerPixel, from, wire, carry, beforeWrap);
+    changed |= applyRun(channels,
+        (from != NULL) ? from + beforeWrap * channelsPerPixel : NULL,
+        wire + beforeWrap * bytesPerPixel,
+        (carry != NULL) ? carry + beforeWrap * bytesPerPixel : NULL,
+        count - beforeWrap);
+    return changed;
+}
+
+bool OutputStage::applyRun(const uint16_t* channels, const uint16_t* from, uint8_t* wire, uint8_t* carry, uint16_t count) const {
+    const bool dither = _settings.dither && !_ditherPaused && carry != NULL;
+    if (from != NULL) {
+        return dither ? apply<true, true>(channels, from, wire, carry, count) :
+            apply<true, false>(channels, from, wire, carry, count);
+    }
+    return dither ? apply<false, true>(channels, from, wire, carry, count) :
+        apply<false, false>(channels, from, wire, carry, count);
+}
+
+// rounds or dithers one 8.8 value into its byte of the wire, returns
+// which bits of the byte changed
+template <bool Dither> static inline uint8_t output(uint8_t* wire, uint8_t* carry, uint8_t index, uint16_t value) {
+    uint8_t sent;
+    if (Dither) {
+        // the largest corrected value is 255.0, so adding a carry of under
+        // one step can't overflow
+        value += carry[index];
+        carry[index] = value;
+        sent = value >> 8;
+    }
+    else {
+        sent = (value + 0x80) >> 8;
+    }
+    uint8_t changed = wire[index] ^ sent;
+    wire[index] = sent;
+    return changed;
+}
+
+template <bool Fading, bool Dither> bool OutputStage::apply(const uint16_t* channels, const uint16_t* from,
+    uint8_t* wire, uint8_t* carry, uint16_t count) const {
+    static_assert(FrameBuffer::ChannelsPerPixel == 3, "apply expects three channel pixels");
+    const uint8_t bytesPerPixel = Strip::BytesPerPixel;
+
+    // what was sent last time is still in wire, so any change is picked up
+    // on the way through rather than with a separate compare
+    uint8_t changed = 0;
+    for (uint16_t pixel = 0; pixel < count; pixel++) {
+        uint16_t first = Correct(0, input<Fading>(channels, from, 0));
+        uint16_t second = Correct(1, input<Fading>(channels, from, 1));
+        uint16_t third = Correct(2, input<Fading>(channels, from, 2));
+        if (Strip::HasWhite) {
+            // the light the three LEDs have in common comes from the white
+            // one, the curve is already applied so this is in light output
+            uint16_t white = (first < second) ? first : second;
+            white = (third < white) ? third : white;
+            first -= white;
+            second -= white;
+            third -= white;
+            changed |= output<Dither>(wire, carry, Strip::White, white);
+        }
+        changed |= output<Dither>(wire, carry, 0, first);
+        changed |= output<Dither>(wire, carry, 1, second);
+        changed |= output<Dither>(wire, carry, 2, third);
+
+        channels += 3;
+        if (Fading) {
+            from += 3;
+        }
+        wire += bytesPerPixel;
+        if (Dither) {
+            carry += bytesPerPixel;
+        }
+    }
+    return changed != 0;
+}
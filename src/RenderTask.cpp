@@ -0,0 +1,80 @@
+#include <RenderTask.h>
+#include <FramePacer.h>
+#include <LEDController.h>
+
+// above loop() and WiFiManager, below the AsyncTCP task so the web server still gets in
+const UBaseType_t RenderTaskPriority = 2;
+const uint32_t RenderTaskStackSize = 4096;
+
+TaskHandle_t renderTaskHandle = NULL;
+FramePacer renderPacer;
+volatile uint32_t renderedFrames = 0;
+TimeHistogram frameTimes;
+volatile uint32_t firstFrameMicros = 0;
+
+void renderTask(void* parameter) {
+    for (;;) {
+        // sleep off whole ticks until the next deadline, anything shorter
+        // is absorbed by the frame starting a little early
+        TickType_t waitTicks = pdMS_TO_TICKS(renderPacer.timeUntilDue(micros()) / 1000);
+        if (waitTicks > 0) {
+            vTaskDelay(waitTicks);
+            continue;
+        }
+
+        uint32_t frameStart = micros();
+        renderPacer.frameStarted(frameStart);
+        // controls from the web server only ever change between frames
+        applyCommands();
+        animationSelector(getSelectedEffect());
+        bool sent = showFrame();
+        uint32_t frameEnd = micros();
+        frameTimes.Record(frameEnd - frameStart);
+        // only once a frame has actually reached the strip, a skipped one
+        // leaves it dark
+        if (sent && firstFrameMicros == 0) {
+            firstFrameMicros = frameEnd;
+        }
+        renderedFrames++;
+
+        // always sleep at least a tick after a frame, one that overran
+        // would otherwise go straight into the next, and this task is above
+        // loop() and the idle task, which feeds the task watchdog
+        vTaskDelay(1);
+    }
+}
+
+void startRenderTask(uint16_t targetFps) {
+    if (renderTaskHandle != NULL) {
+        return;
+    }
+    renderPacer.setTargetFps(targetFps);
+    xTaskCreate(renderTask, "render", RenderTaskStackSize, NULL, RenderTaskPriority, &renderTaskHandle);
+}
+
+void setRenderFps(uint16_t targetFps) {
+    renderPacer.setTargetFps(targetFps);
+}
+
+uint32_t getTimeUntilNextFrame() {
+    return renderPacer.timeUntilDue(micros());
+}
+
+RenderStats getRenderStats() {
+    RenderStats stats;
+    stats.targetFps = renderPacer.getTargetFps();
+    stats.frames = renderedFrames;
+    FrameCounters counters = getFrameCounters();
+    stats.shows = counters.sent;
+    stats.skipped = counters.skipped;
+    stats.dropped = renderPacer.getDroppedFrames();
+    return stats;
+}
+
+const TimeHistogram& getFrameTimes() {
+    return frameTimes;
+}
+
+uint32_t getFirstFrameTime() {
+    return firstFrameMicros;
+}
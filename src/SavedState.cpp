@@ -0,0 +1,58 @@
+#include <SavedState.h>
+#include <Preferences.h>
+
+const char* StateNamespace = "state";
+const char* StateKey = "saved";
+// bump when SavedState changes so an old record isn't read as a new one
+const uint8_t StateVersion = 2;
+// no padding, so the CRC only ever covers values that were set
+static_assert(sizeof(SavedState) == 40, "SavedState must not have padding");
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    // a bit at a time, it only runs at boot and when saving
+    uint32_t crc = 0xffffffff;
+    for (size_t index = 0; index < length; index++) {
+        crc ^= data[index];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t stateCrc(const SavedState& state) {
+    return crc32((const uint8_t*)&state, offsetof(SavedState, crc));
+}
+
+bool loadSavedState(SavedState& state) {
+    Preferences preferences;
+    if (!preferences.begin(StateNamespace, true)) {
+        return false;
+    }
+
+    SavedState saved;
+    bool found = preferences.getBytesLength(StateKey) == sizeof(saved) &&
+        preferences.getBytes(StateKey, &saved, sizeof(saved)) == sizeof(saved);
+    preferences.end();
+
+    // a write cut short by losing power fails the CRC
+    if (!found || saved.version != StateVersion || saved.crc != stateCrc(saved)) {
+        return false;
+    }
+    state = saved;
+    return true;
+}
+
+bool saveSavedState(const SavedState& state) {
+    SavedState record = state;
+    record.version = StateVersion;
+    record.crc = stateCrc(record);
+
+    Preferences preferences;
+    if (!preferences.begin(StateNamespace, false)) {
+        return false;
+    }
+    bool saved = preferences.putBytes(StateKey, &record, sizeof(record)) == sizeof(record);
+    preferences.end();
+    return saved;
+}
@@ -0,0 +1,24 @@
+#include <StreamInput.h>
+#include <LEDController.h>
+#include <AsyncUDP.h>
+
+// AsyncUDP runs every socket's callbacks on its one task, which makes it
+// the single producer the stream receiver needs
+AsyncUDP e131Socket;
+AsyncUDP artNetSocket;
+
+void receivePacket(AsyncUDPPacket& packet) {
+    // the packet is read where lwIP left it, nothing is copied out first
+    getStreamReceiver().Receive(packet.data(), packet.length(), millis());
+}
+
+void startStreamInput() {
+    // unicast and broadcast only, point the show controller at the mirror
+    // rather than using E1.31 multicast
+    if (e131Socket.listen(E131Port)) {
+        e131Socket.onPacket(receivePacket);
+    }
+    if (artNetSocket.listen(ArtNetPort)) {
+        artNetSocket.onPacket(receivePacket);
+    }
+}
@@ -0,0 +1,287 @@
+#include <StreamReceiver.h>
+
+StreamReceiver::StreamReceiver() :
+    _count(0),
+    _firstUniverse(1),
+    _universeCount(0),
+    _latency(DefaultLatency),
+    _timeout(DefaultTimeout),
+    _filling(-1),
+    _lastFrame(0),
+    _interval(0),
+    _received(0),
+    _sequenced(0),
+    _lastPacket(0),
+    _started(false),
+    _terminated(false),
+    _next(-1),
+    _nextDue(0),
+    _scheduled(false) {
+    memset(&_stats, 0, sizeof(_stats));
+    for (uint8_t slot = 0; slot < SlotCount; slot++) {
+        _slots[slot] = NULL;
+        _arrived[slot] = 0;
+        _intervals[slot] = 0;
+    }
+}
+
+void StreamReceiver::Begin(uint16_t count, uint16_t firstUniverse) {
+    if (_count != 0 || count == 0 || count > MaxPixelCount) {
+        return;
+    }
+    _count = count;
+    _firstUniverse = firstUniverse;
+    _universeCount = (count + PixelsPerUniverse - 1) / PixelsPerUniverse;
+
+    // every slot starts out free for the network task to fill
+    for (uint8_t slot = 0; slot < SlotCount; slot++) {
+        _slots[slot] = new uint16_t[count * FrameBuffer::ChannelsPerPixel]();
+        _free.Push(slot);
+    }
+}
+
+
+/* NETWORK TASK */
+bool StreamReceiver::parseE131(const uint8_t* packet, size_t length, Universe& universe) {
+    static const uint8_t Identifier[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+    const size_t DataOffset = 126;
+
+    // root, framing and DMP layer vectors of a data packet, then the DMX
+    // start code, anything else is sync, discovery or not DMX at all
+    if (length < DataOffset || memcmp(packet + 4, Identifier, sizeof(Identifier)) != 0 ||
+        packet[21] != 0x04 || packet[43] != 0x02 || packet[117] != 0x02 || packet[125] != 0) {
+        return false;
+    }
+    // preview data is for visualisers, not the lights themselves
+    const uint8_t options = packet[112];
+    if (options & 0x80) {
+        return false;
+    }
+
+    // the count includes the start code
+    uint16_t count = (packet[123] << 8) | packet[124];
+    if (count < 1 || DataOffset - 1 + count > length) {
+        return false;
+    }
+
+    universe.data = packet + DataOffset;
+    universe.length = count - 1;
+    universe.number = (packet[113] << 8) | packet[114];
+    universe.sequence = packet[111];
+    universe.numbered = true;
+    universe.terminated = (options & 0x40) != 0;
+    return true;
+}
+
+bool StreamReceiver::parseArtNet(const uint8_t* packet, size_t length, Universe& universe) {
+    static const uint8_t Identifier[8] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+    const size_t DataOffset = 18;
+
+    // OpDmx, the opcode is little endian unlike everything else
+    if (length < DataOffset || memcmp(packet, Identifier, sizeof(Identifier)) != 0 ||
+        packet[8] != 0x00 || packet[9] != 0x50) {
+        return false;
+    }
+
+    uint16_t count = (packet[16] << 8) | packet[17];
+    if (DataOffset + count > length) {
+        return false;
+    }
+
+    universe.data = packet + DataOffset;
+    universe.length = count;
+    universe.number = ((packet[15] & 0x7f) << 8) | packet[14];
+    // Art-Net senders that don't number their packets send 0
+    universe.sequence = packet[12];
+    universe.numbered = packet[12] != 0;
+    universe.terminated = false;
+    return true;
+}
+
+bool StreamReceiver::Receive(const uint8_t* packet, size_t length, uint32_t nowMillis) {
+    Universe universe;
+    if (_count == 0 || (!parseE131(packet, length, universe) && !parseArtNet(packet, length, universe))) {
+        return false;
+    }
+    if (universe.number < _firstUniverse || universe.number - _firstUniverse >= _universeCount) {
+        return false;
+    }
+    const uint8_t index = universe.number - _firstUniverse;
+    const uint16_t bit = 1 << index;
+    _stats.packets++;
+
+    // after a gap nothing received before it belongs with what comes next
+    if (!_started || (int32_t)(nowMillis - _lastPacket.load()) >= (int32_t)_timeout) {
+        _received = 0;
+        _sequenced = 0;
+        _interval = 0;
+    }
+
+    if (universe.numbered) {
+        if (_sequenced & bit) {
+            // as E1.31 has it, up to 20 behind is a late packet rather
+            // than the counter wrapping round
+            int8_t step = universe.sequence - _sequences[index];
+            if (step <= 0 && step > -20) {
+                _stats.outOfOrder++;
+                return true;
+            }
+            if (step > 1) {
+                _stats.lost += step - 1;
+            }
+        }
+        _sequences[index] = universe.sequence;
+        _sequenced |= bit;
+    }
+
+    _lastPacket.store(nowMillis);
+    _started.store(true);
+    if (universe.terminated) {
+        _terminated.store(true);
+        _received = 0;
+        return true;
+    }
+    _terminated.store(false);
+
+    if (_filling < 0) {
+        uint8_t slot;
+        if (!_free.Pop(slot)) {
+            // the render task is holding every slot, it will catch up
+            _stats.overruns++;
+            return true;
+        }
+        _filling = slot;
+        _received = 0;
+    }
+    if (_received & bit) {
+        // this universe came round again before the frame was whole
+        _stats.incomplete++;
+        _received = 0;
+    }
+
+    // straight from the packet into the slot, a short universe is padded
+    // with black so nothing is left over from an old frame
+    FrameBuffer slot(_slots[_filling], _count);
+    const uint16_t first = index * PixelsPerUniverse;
+    const uint16_t universePixels = (_count - first < PixelsPerUniverse) ? _count - first : PixelsPerUniverse;
+    const uint16_t pixels = (universe.length / 3 < universePixels) ? universe.length / 3 : universePixels;
+    const uint8_t* rgb = universe.data;
+    for (uint16_t pixel = 0; pixel < pixels; pixel++, rgb += 3) {
+        slot.SetPixelColor(first + pixel, FrameColor(rgb[0] * 257, rgb[1] * 257, rgb[2] * 257));
+    }
+    if (pixels < universePixels) {
+        slot.Fill(FrameColor(), first + pixels, universePixels - pixels);
+    }
+    _received |= bit;
+
+    if (_received == (1U << _universeCount) - 1) {
+        // a running average, a sixteenth of the way to each new gap, so one
+        // late frame barely moves it
+        uint32_t gap = (nowMillis - _lastFrame) << 4;
+        if (_interval == 0) {
+            _interval = (_stats.frames > 0 && gap < (_timeout << 4)) ? gap : 0;
+        }
+        else {
+            _interval = _interval + ((int32_t)(gap - _interval) >> 4);
+        }
+        _lastFrame = nowMillis;
+
+        // written before the slot is queued, so they go with it
+        _arrived[_filling] = nowMillis;
+        _intervals[_filling] = _interval;
+        _ready.Push(_filling);
+        _filling = -1;
+        _received = 0;
+        _stats.frames++;
+    }
+    return true;
+}
+
+
+/* RENDER TASK */
+bool StreamReceiver::IsActive(uint32_t nowMillis) const {
+    // signed, the network task may have read a later millis() than ours
+    return _started.load() && !_terminated.load() &&
+        (int32_t)(nowMillis - _lastPacket.load()) < (int32_t)_timeout;
+}
+
+bool StreamReceiver::Exchange(FrameBuffer& frame, uint32_t nowMillis) {
+    // of the frames that have waited out the latency only the newest is
+    // shown, the render loop has fallen behind the sender for the others
+    int8_t due = -1;
+    for (;;) {
+        if (_next < 0) {
+            uint8_t slot;
+            if (!_ready.Pop(slot)) {
+                break;
+            }
+            _next = slot;
+            schedule(slot);
+        }
+        if ((int32_t)(nowMillis - _nextDue) < 0) {
+            break;
+        }
+        if (due >= 0) {
+            release(due);
+            _stats.skipped++;
+        }
+        due = _next;
+        _next = -1;
+    }
+
+    if (due < 0) {
+        return false;
+    }
+    if (frame.PixelCount() != _count) {
+        release(due);
+        return false;
+    }
+
+    // the slot becomes the frame, and what the frame was showing becomes
+    // the slot the next frame received is written into
+    uint16_t* shown = frame.Channels();
+    frame = FrameBuffer(_slots[due], _count);
+    frame.Dirty();
+    _slots[due] = shown;
+    release(due);
+    _stats.shown++;
+    return true;
+}
+
+void StreamReceiver::schedule(uint8_t slot) {
+    // one interval after the frame before, or a latency after this one
+    // arrived if there is no frame before to follow on from
+    const uint32_t arrived = _arrived[slot];
+    uint32_t due = arrived + _latency;
+    if (_scheduled && _intervals[slot] > 0) {
+        due = _nextDue + ((_intervals[slot] + 8) >> 4);
+        int32_t wait = due - arrived;
+        if (wait < 0) {
+            // later than the latency covers, show it now and carry on from it
+            due = arrived;
+        }
+        else if (wait > 2 * (int32_t)_latency) {
+            // the sender is slower than the average, start again from here
+            due = arrived + _latency;
+        }
+    }
+    _nextDue = due;
+    _scheduled = true;
+}
+
+void StreamReceiver::Flush() {
+    _scheduled = false;
+    if (_next >= 0) {
+        release(_next);
+        _next = -1;
+    }
+    uint8_t slot;
+    while (_ready.Pop(slot)) {
+        release(slot);
+    }
+}
+
+void StreamReceiver::release(uint8_t slot) {
+    // never full, there are only SlotCount slots to go round
+    _free.Push(slot);
+}
@@ -0,0 +1,145 @@
+#include <StripOutput.h>
+#include <Preferences.h>
+
+/* LAYOUT */
+const char* LayoutNamespace = "strip";
+const char* LayoutKey = "layout";
+
+uint16_t getLayoutPixelCount(const StripLayout& layout) {
+    uint16_t count = 0;
+    for (uint8_t segment = 0; segment < layout.segmentCount && segment < MaxStripSegments; segment++) {
+        count += layout.segments[segment].count;
+    }
+    return count;
+}
+
+bool isValidLayout(const StripLayout& layout) {
+    if (layout.segmentCount == 0 || layout.segmentCount > MaxStripSegments) {
+        return false;
+    }
+
+    uint32_t total = 0;
+    for (uint8_t segment = 0; segment < layout.segmentCount; segment++) {
+        const StripSegment& strip = layout.segments[segment];
+        if (strip.count == 0) {
+            return false;
+        }
+        // 26 to 32 are wired to the flash and psram, 46 is input only
+        if (strip.pin > 45 || (strip.pin >= 26 && strip.pin <= 32)) {
+            return false;
+        }
+        // two channels can't drive the same pin
+        for (uint8_t other = 0; other < segment; other++) {
+            if (layout.segments[other].pin == strip.pin) {
+                return false;
+            }
+        }
+        total += strip.count;
+    }
+    // a fixed installation is built for exactly its pixel count
+    if (Strip::PixelCount != 0 && total != Strip::PixelCount) {
+        return false;
+    }
+    return total <= MaxPixelCount;
+}
+
+bool loadStripLayout(StripLayout& layout) {
+    Preferences preferences;
+    if (!preferences.begin(LayoutNamespace, true)) {
+        return false;
+    }
+
+    StripLayout saved;
+    bool found = preferences.getBytesLength(LayoutKey) == sizeof(saved) &&
+        preferences.getBytes(LayoutKey, &saved, sizeof(saved)) == sizeof(saved);
+    preferences.end();
+
+    if (!found || !isValidLayout(saved)) {
+        return false;
+    }
+    layout = saved;
+    return true;
+}
+
+bool saveStripLayout(const StripLayout& layout) {
+    if (!isValidLayout(layout)) {
+        return false;
+    }
+
+    // copy into a zeroed record so the padding saved is always the same
+    StripLayout record;
+    memset(&record, 0, sizeof(record));
+    record.segmentCount = layout.segmentCount;
+    for (uint8_t segment = 0; segment < layout.segmentCount; segment++) {
+        record.segments[segment] = layout.segments[segment];
+    }
+
+    Preferences preferences;
+    if (!preferences.begin(LayoutNamespace, false)) {
+        return false;
+    }
+    bool saved = preferences.putBytes(LayoutKey, &record, sizeof(record)) == sizeof(record);
+    preferences.end();
+    return saved;
+}
+
+
+/* OUTPUT */
+// each segment gets the RMT channel of the same number
+static StripBus* createBus(uint8_t channel, const StripSegment& segment) {
+    switch (channel) {
+    case 0:
+        return new NeoStripBus<NeoEsp32Rmt0Ws2812xMethod>(segment.count, segment.pin);
+    case 1:
+        return new NeoStripBus<NeoEsp32Rmt1Ws2812xMethod>(segment.count, segment.pin);
+    case 2:
+        return new NeoStripBus<NeoEsp32Rmt2Ws2812xMethod>(segment.count, segment.pin);
+    case 3:
+        return new NeoStripBus<NeoEsp32Rmt3Ws2812xMethod>(segment.count, segment.pin);
+    default:
+        return NULL;
+    }
+}
+
+StripOutput::StripOutput() :
+    _segmentCount(0),
+    _pixelCount(0) {
+}
+
+bool StripOutput::Begin(const StripLayout& layout) {
+    if (_segmentCount != 0 || !isValidLayout(layout)) {
+        return false;
+    }
+
+    uint16_t first = 0;
+    for (uint8_t segment = 0; segment < layout.segmentCount; segment++) {
+        StripBus* bus = createBus(segment, layout.segments[segment]);
+        if (bus == NULL) {
+            break;
+        }
+        bus->Begin();
+        bus->Show();
+
+        _buses[segment] = bus;
+        _first[segment] = first;
+        _count[segment] = layout.segments[segment].count;
+        first += _count[segment];
+        _segmentCount++;
+    }
+    _pixelCount = first;
+    return _segmentCount == layout.segmentCount;
+}
+
+bool StripOutput::Show(const FrameBuffer& frame, OutputStage& stage) {
+    bool sent = false;
+    for (uint8_t segment = 0; segment < _segmentCount; segment++) {
+        // Show() keeps Pixels() holding what was last sent, so the output
+        // stage can tell if the segment changed as it writes the new values
+        if (!stage.Apply(frame, _buses[segment]->Pixels(), _first[segment], _count[segment])) {
+            continue;
+        }
+        _buses[segment]->Show();
+        sent = true;
+    }
+    return sent;
+}
@@ -0,0 +1,65 @@
+#include <TimeHistogram.h>
+
+TimeHistogram::TimeHistogram() {
+    Reset();
+}
+
+void TimeHistogram::Reset() {
+    memset(_buckets, 0, sizeof(_buckets));
+    _count = 0;
+    _min = UINT32_MAX;
+    _max = 0;
+    _sum = 0;
+}
+
+void TimeHistogram::Record(uint32_t value) {
+    _buckets[bucketOf(value)]++;
+    _count++;
+    _sum += value;
+    if (value < _min) {
+        _min = value;
+    }
+    if (value > _max) {
+        _max = value;
+    }
+}
+
+uint32_t TimeHistogram::Percentile(uint8_t percent) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    // the smallest bucket with at least that share of the count at or below it
+    uint32_t wanted = ((uint64_t)_count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < BucketCount; bucket++) {
+        seen += _buckets[bucket];
+        if (seen >= wanted && seen > 0) {
+            // the last bucket has no top, anything past 2^24 is in it
+            uint32_t top = (bucket < BucketCount - 1) ? bucketTop(bucket) : _max;
+            return (top < _max) ? top : _max;
+        }
+    }
+    return _max;
+}
+
+uint8_t TimeHistogram::bucketOf(uint32_t value) {
+    if (value < 8) {
+        return value;
+    }
+    // the power of two, then the next three bits below the top one
+    uint8_t power = 31 - __builtin_clz(value);
+    if (power > 23) {
+        return BucketCount - 1;
+    }
+    return (power - 2) * 8 + ((value >> (power - 3)) & 7);
+}
+
+uint32_t TimeHistogram::bucketTop(uint8_t bucket) {
+    if (bucket < 8) {
+        return bucket;
+    }
+    uint8_t shift = bucket / 8 - 1;
+    uint32_t bottom = (uint32_t)(8 + bucket % 8) << shift;
+    return bottom + (1UL << shift) - 1;
+}
@@ -2,18 +2,42 @@
 #include <LEDController.h>
 #include <WiFiManager.h>
 #include <EffectSelectorPage.h>
+#include <RenderTask.h>
+#include <StreamInput.h>
 
 // WiFI Manager
 WiFiManager wm;
 
+// Frame rate the render task runs the animations at
+const uint16_t TargetFps = 60;
+// a small NVS write takes a few ms and stops the CPU while it does
+const uint32_t SaveWindow = 5000; // us
+
 // put function declarations here:
 int animationState;
 
 
 
+// Boot progress on the serial port, so time to first frame can be measured
+void logBootPhase(const char* phase) {
+  Serial.printf("boot %8lu us %s\n", (unsigned long)micros(), phase);
+}
+
 void setup() {
   Serial.begin(115200);
-  
+  logBootPhase("start");
+
+  // Initalise the LED Strip first, it comes back with the effect and colour
+  // it had before the restart and nothing in it waits on the network
+  initStrip();
+  logBootPhase("strip ready");
+
+  // Animations are drawn from their own task so WiFi and the web server
+  // don't affect the frame rate. It's above this one, so the first frame
+  // goes out while WiFi is still coming up below
+  startRenderTask(TargetFps);
+  logBootPhase("render task started");
+
   // Set Up WiFi
   WiFi.mode(WIFI_STA); // explicitly set mode, esp defaults to STA+AP        
   wm.setHostname("Inifnity Mirror");
@@ -31,19 +55,43 @@ void setup() {
   else {
     Serial.println("Configportal running");
   }
+  logBootPhase("wifi up");
 
   // Initalise Web Server
   startWebServer();
 
-
-  // Initalise the LED Strip and set the default colour to Red
-  initStrip();
-  changeCylonColour(HtmlColor(0x7f0000));
+  // a show controller can stream frames in place of the effects
+  startStreamInput();
+  logBootPhase("network ready");
 }
 
 void loop() {
+  countLoop();
+
+  static bool firstFrameLogged = false;
+  if (!firstFrameLogged && getFirstFrameTime() != 0) {
+    Serial.printf("boot %8lu us first frame\n", (unsigned long)getFirstFrameTime());
+    firstFrameLogged = true;
+  }
+
   // Process the WiFi Manager Captive Portal
   wm.process();
 
-  animationSelector(getAnimation());
+  // keep every open page showing what the mirror is doing
+  pushState();
+
+  // flash writes happen here rather than in the render task, and only in
+  // the gap after a frame so they can't hold the next one up
+  if (getTimeUntilNextFrame() > SaveWindow) {
+    // a new strip layout is only picked up at boot, the reply has had
+    // at least a frame to go out and gets a little longer
+    if (saveRequestedLayout()) {
+      delay(500);
+      ESP.restart();
+    }
+    saveStateWhenQuiet();
+  }
+
+  // let the idle task run, the render task does the drawing
+  delay(1);
 }
@@ -0,0 +1,61 @@
+#ifndef BENCH_BASELINE_H
+#define BENCH_BASELINE_H
+
+// Stored benchmark results, refresh them by running the suite with -v and
+// copying the reported numbers after an intended change in frame cost.
+
+#include <cstdint>
+#include <cstddef>
+
+// how much slower than baseline an effect may get before the test fails,
+// host timings are noisy so only real regressions should trip this
+#ifndef BENCH_TOLERANCE
+#define BENCH_TOLERANCE 2.0
+#endif
+const double BenchTolerance = BENCH_TOLERANCE;
+
+struct BenchBaseline {
+    int animation;
+    uint16_t pixelCount;
+    double nsPerFrame;
+    double allocationsPerFrame;
+};
+
+const BenchBaseline benchBaselines[] = {
+    // animation, pixels, ns/frame, allocs/frame
+    // effects must never touch the heap, so allocations stay at 0
+    // dithering runs the output stage on every frame, animation 0 (off)
+    // is that cost on its own
+    { 0, 45, 300, 0 },
+    { 1, 45, 650, 0 },
+    { 2, 45, 450, 0 },
+    { 3, 45, 700, 0 },
+    { 4, 45, 400, 0 },
+    { 5, 45, 550, 0 },
+    { 6, 45, 500, 0 },
+    { 0, 300, 2800, 0 },
+    { 1, 300, 4500, 0 },
+    { 2, 300, 2800, 0 },
+    { 3, 300, 4000, 0 },
+    { 4, 300, 2200, 0 },
+    { 5, 300, 3600, 0 },
+    { 6, 300, 2500, 0 },
+    { 0, 1200, 5800, 0 },
+    { 1, 1200, 13000, 0 },
+    { 2, 1200, 9000, 0 },
+    { 3, 1200, 12000, 0 },
+    { 4, 1200, 9000, 0 },
+    { 5, 1200, 9500, 0 },
+    { 6, 1200, 8000, 0 },
+};
+
+inline const BenchBaseline* findBaseline(int animation, uint16_t pixelCount) {
+    for (size_t index = 0; index < sizeof(benchBaselines) / sizeof(benchBaselines[0]); index++) {
+        if (benchBaselines[index].animation == animation && benchBaselines[index].pixelCount == pixelCount) {
+            return &benchBaselines[index];
+        }
+    }
+    return nullptr;
+}
+
+#endif
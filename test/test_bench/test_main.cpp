@@ -0,0 +1,165 @@
+// Frame-time benchmark for the effects dispatched by animationSelector().
+// Each effect runs for a fixed number of virtual 60 fps frames on the host
+// stand-in and fails if it is slower, or allocates more, than baseline.h.
+//
+//   pio test -e native -e native_300 -e native_1200 -f test_bench -v
+#include <unity.h>
+#include <LEDController.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "baseline.h"
+
+// count every heap allocation the effects make
+static uint32_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept {
+    free(p);
+}
+
+const uint32_t WarmUpFrames = 100;
+const uint32_t BenchFrames = 4000;
+const uint32_t BenchRuns = 5; // best of, to keep scheduler noise out of the numbers
+const uint32_t FrameMs = 16; // 60 fps
+const uint32_t BenchSeed = 1; // every run draws the same effects
+const double FrameBudgetNs = 1000000000.0 / 60;
+// WS2812 wire time, 24 bits at 1.25us per pixel plus the 300us latch
+const double WireNsPerPixel = 30000.0;
+const double WireLatchNs = 300000.0;
+
+struct BenchResult {
+    double nsPerFrame;
+    double nsPerPixel;
+    double allocationsPerFrame;
+};
+
+static BenchResult runAnimation(int animation) {
+    // switching effects is counted too, setting one up must not allocate either
+    uint32_t allocationsBefore = allocations;
+
+    // start every effect from a dark, stopped strip
+    animationSelector(0);
+    for (uint32_t frame = 0; frame < WarmUpFrames; frame++) {
+        hostAdvanceMillis(FrameMs);
+        animationSelector(animation);
+        showFrame();
+    }
+
+    double bestNs = 0;
+    for (uint32_t run = 0; run < BenchRuns; run++) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < BenchFrames; frame++) {
+            hostAdvanceMillis(FrameMs);
+            animationSelector(animation);
+            showFrame();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        if (run == 0 || ns < bestNs) {
+            bestNs = ns;
+        }
+    }
+
+    BenchResult result;
+    result.nsPerFrame = bestNs / BenchFrames;
+    result.nsPerPixel = result.nsPerFrame / getPixelCount();
+    result.allocationsPerFrame = (double)(allocations - allocationsBefore) / (WarmUpFrames + BenchFrames * BenchRuns);
+    return result;
+}
+
+static void benchAnimation(int animation) {
+    const BenchBaseline* baseline = findBaseline(animation, getPixelCount());
+    BenchResult result = runAnimation(animation);
+
+    // wire time is fixed by the strip, host compute is a lower bound for the S2
+    double wireNs = WireLatchNs + WireNsPerPixel * getPixelCount();
+    bool fits = (wireNs + result.nsPerFrame) < FrameBudgetNs;
+
+    char message[200];
+    snprintf(message, sizeof(message),
+        "%s @ %u px: %.0f ns/frame, %.2f ns/pixel, %.3f allocs/frame, wire %.2f ms%s",
+        getEffectName(animation), getPixelCount(), result.nsPerFrame, result.nsPerPixel,
+        result.allocationsPerFrame, wireNs / 1000000.0, fits ? "" : " (over 60 fps budget)");
+    TEST_MESSAGE(message);
+
+    if (baseline == nullptr) {
+        TEST_IGNORE_MESSAGE("no baseline stored for this pixel count");
+    }
+
+    snprintf(message, sizeof(message), "ns/frame %.0f regressed past baseline %.0f",
+        result.nsPerFrame, baseline->nsPerFrame);
+    TEST_ASSERT_TRUE_MESSAGE(result.nsPerFrame <= baseline->nsPerFrame * BenchTolerance, message);
+
+    snprintf(message, sizeof(message), "allocs/frame %.3f regressed past baseline %.3f",
+        result.allocationsPerFrame, baseline->allocationsPerFrame);
+    TEST_ASSERT_TRUE_MESSAGE(result.allocationsPerFrame <= baseline->allocationsPerFrame, message);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_output_stage(void) {
+    // nothing is drawn while off, but dithering still runs the whole
+    // output stage every frame, so this is its cost on its own
+    benchAnimation(0);
+}
+
+void test_basic_animation(void) {
+    benchAnimation(1);
+}
+
+void test_fade_in_fade_out(void) {
+    benchAnimation(2);
+}
+
+void test_random_change(void) {
+    benchAnimation(3);
+}
+
+void test_rotating_loop(void) {
+    benchAnimation(4);
+}
+
+void test_cylon(void) {
+    benchAnimation(5);
+}
+
+void test_fun_rotating_loop(void) {
+    benchAnimation(6);
+}
+
+int main(int argc, char** argv) {
+    initStrip();
+    SetRandomSeed(BenchSeed);
+    changeCylonColour(HtmlColor(0x7f0000));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_output_stage);
+    RUN_TEST(test_basic_animation);
+    RUN_TEST(test_fade_in_fade_out);
+    RUN_TEST(test_random_change);
+    RUN_TEST(test_rotating_loop);
+    RUN_TEST(test_cylon);
+    RUN_TEST(test_fun_rotating_loop);
+    return UNITY_END();
+}
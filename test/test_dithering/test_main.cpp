@@ -0,0 +1,204 @@
+// Checks the temporal dithering in OutputStage: averaged over frames the
+// 8 bit output has to land on the 16 bit value the effect drew, exact
+// 8 bit values must not flicker, and it has to do clearly better than
+// rounding every frame the same way. A frame that stands still stops
+// being dithered, so it stops being sent.
+//
+//   pio test -e native -f test_dithering -v
+#include <unity.h>
+#include <OutputStage.h>
+#include <LEDController.h>
+
+#include <cstdio>
+
+const uint16_t TestPixels = 8;
+const uint32_t Frames = 100; // under two seconds at 60 fps
+
+static uint16_t channels[TestPixels * FrameBuffer::ChannelsPerPixel];
+static uint8_t wire[TestPixels * FrameBuffer::ChannelsPerPixel];
+
+static OutputSettings settingsFor(float gamma, uint8_t brightness, bool dither) {
+    OutputSettings settings = { gamma, brightness, RgbColor(255, 255, 255), dither };
+    return settings;
+}
+
+// mean over every channel of |average output - exact output| in 8.8 fixed
+// point, so 256 is one whole 8 bit step
+static double averageError(const OutputSettings& settings, uint16_t value) {
+    OutputStage stage;
+    stage.Begin(TestPixels);
+    stage.SetSettings(settings);
+
+    FrameBuffer frame(channels, TestPixels);
+    frame.Fill(FrameColor(value, value, value), 0, TestPixels);
+
+    uint32_t sums[TestPixels * FrameBuffer::ChannelsPerPixel] = { 0 };
+    for (uint32_t count = 0; count < Frames; count++) {
+        stage.Apply(frame, wire, 0, TestPixels);
+        for (size_t index = 0; index < sizeof(wire); index++) {
+            sums[index] += wire[index];
+        }
+    }
+
+    double error = 0;
+    for (size_t index = 0; index < sizeof(wire); index++) {
+        double average = sums[index] * 256.0 / Frames;
+        double exact = stage.Correct(index % FrameBuffer::ChannelsPerPixel, value);
+        error += fabs(average - exact);
+    }
+    return error / sizeof(wire);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_dither_averages_to_the_16_bit_value(void) {
+    // linear and the default curve at low brightness, where stepping shows
+    const OutputSettings curves[] = {
+        settingsFor(1.0f, 255, true),
+        settingsFor(1.0f / 0.45f, 51, true),
+    };
+    for (size_t curve = 0; curve < sizeof(curves) / sizeof(curves[0]); curve++) {
+        double worst = 0;
+        for (uint32_t value = 0; value < 65536; value += 37) {
+            double error = averageError(curves[curve], value);
+            if (error > worst) {
+                worst = error;
+            }
+            // whatever is still carried after the last frame, under a step
+            // spread over all of them
+            TEST_ASSERT_TRUE_MESSAGE(error < 256.0 / Frames, "dithered average strays from the exact value");
+        }
+        printf("  curve %u: worst average error %.3f/256 of a step over %u frames\n",
+            (unsigned)curve, worst, Frames);
+    }
+}
+
+void test_dither_beats_rounding(void) {
+    double dithered = 0;
+    double rounded = 0;
+    uint32_t samples = 0;
+    // the bottom of the default curve at 20% brightness, the fade effects' range
+    for (uint32_t value = 0; value < 16384; value += 11) {
+        dithered += averageError(settingsFor(1.0f / 0.45f, 51, true), value);
+        rounded += averageError(settingsFor(1.0f / 0.45f, 51, false), value);
+        samples++;
+    }
+    dithered /= samples;
+    rounded /= samples;
+    printf("  mean error %.3f/256 of a step dithered, %.3f/256 rounded\n", dithered, rounded);
+    TEST_ASSERT_TRUE(dithered * 10 < rounded);
+}
+
+void test_exact_values_do_not_flicker(void) {
+    OutputStage stage;
+    stage.Begin(TestPixels);
+    stage.SetSettings(settingsFor(1.0f, 255, true));
+    FrameBuffer frame(channels, TestPixels);
+
+    for (int value = 0; value < 256; value++) {
+        frame.Fill(RgbColor(value), 0, TestPixels);
+        stage.Apply(frame, wire, 0, TestPixels);
+        for (uint32_t count = 0; count < 8; count++) {
+            // once it has been sent, nothing changes while the frame doesn't
+            TEST_ASSERT_FALSE(stage.Apply(frame, wire, 0, TestPixels));
+            for (size_t index = 0; index < sizeof(wire); index++) {
+                TEST_ASSERT_EQUAL_UINT8(value, wire[index]);
+            }
+        }
+    }
+}
+
+void test_rotation_follows_the_carry(void) {
+    // the carry belongs to the strip position, rotating the frame must not
+    // change what each position averages to for a uniform fill
+    OutputStage stage;
+    stage.Begin(TestPixels);
+    stage.SetSettings(settingsFor(1.0f, 255, true));
+    FrameBuffer frame(channels, TestPixels);
+    frame.Fill(FrameColor(1000, 2000, 3000), 0, TestPixels);
+
+    uint32_t sums[TestPixels * FrameBuffer::ChannelsPerPixel] = { 0 };
+    for (uint32_t count = 0; count < Frames; count++) {
+        frame.RotateRight(3);
+        stage.Apply(frame, wire, 0, TestPixels);
+        for (size_t index = 0; index < sizeof(wire); index++) {
+            sums[index] += wire[index];
+        }
+    }
+    for (size_t index = 0; index < sizeof(wire); index++) {
+        double average = sums[index] * 256.0 / Frames;
+        double exact = stage.Correct(index % FrameBuffer::ChannelsPerPixel, channels[index % FrameBuffer::ChannelsPerPixel]);
+        TEST_ASSERT_TRUE(fabs(average - exact) < 256.0 / Frames);
+    }
+}
+
+void test_brightness_scales_the_cached_curve(void) {
+    // brightness and white balance are folded into the gamma curve with an
+    // integer multiply, which has to stay within a few 256ths of a step of
+    // the float, one rounding for the curve, one for the scale and the last
+    OutputStage stage;
+    const uint8_t brightnesses[] = { 255, 200, 51, 1, 0 };
+    for (size_t brightness = 0; brightness < sizeof(brightnesses); brightness++) {
+        OutputSettings settings = { 1.0f / 0.45f, brightnesses[brightness], RgbColor(255, 180, 7), false };
+        stage.SetSettings(settings);
+        const uint8_t scales[] = { 255, 180, 7 };
+        const uint8_t positions[] = { FrameBuffer::Red, FrameBuffer::Green, FrameBuffer::Blue };
+        for (uint8_t channel = 0; channel < 3; channel++) {
+            for (uint16_t step = 0; step < 256; step++) {
+                double exact = pow(step / 255.0, 1.0 / 0.45) * (255 << 8) *
+                    (brightnesses[brightness] / 255.0) * (scales[channel] / 255.0);
+                double corrected = stage.Correct(positions[channel], step * 257);
+                TEST_ASSERT_TRUE(fabs(corrected - exact) <= 1.5);
+            }
+        }
+    }
+}
+
+static uint32_t framesSent(int animation, uint32_t frames) {
+    const uint32_t before = getFrameCounters().sent;
+    for (uint32_t count = 0; count < frames; count++) {
+        hostAdvanceMillis(16);
+        animationSelector(animation);
+        showFrame();
+    }
+    return getFrameCounters().sent - before;
+}
+
+void test_still_frame_stops_dithering(void) {
+    // the default curve with dithering, part way into a fade so the values
+    // have fractions to carry
+    const int FadeInFadeOut = 2;
+    setOutputSettings(settingsFor(1.0f / 0.45f, 255, true));
+    setTransitionTime(0);
+    framesSent(FadeInFadeOut, 40);
+
+    // paused, the frame stands still but dithering keeps moving the output
+    setEffectSpeed(0);
+    TEST_ASSERT_TRUE(framesSent(FadeInFadeOut, 30) > 0);
+    // for a second, then one rounded frame and nothing after it
+    framesSent(FadeInFadeOut, 31);
+    TEST_ASSERT_EQUAL_UINT32(0, framesSent(FadeInFadeOut, 120));
+
+    // and as soon as the frame moves again it is dithered again
+    setEffectSpeed(100);
+    TEST_ASSERT_TRUE(framesSent(FadeInFadeOut, 10) > 0);
+    animationSelector(0);
+    showFrame();
+}
+
+int main(int argc, char** argv) {
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_dither_averages_to_the_16_bit_value);
+    RUN_TEST(test_dither_beats_rounding);
+    RUN_TEST(test_exact_values_do_not_flicker);
+    RUN_TEST(test_rotation_follows_the_carry);
+    RUN_TEST(test_brightness_scales_the_cached_curve);
+    RUN_TEST(test_still_frame_stops_dithering);
+    return UNITY_END();
+}
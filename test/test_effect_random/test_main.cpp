@@ -0,0 +1,142 @@
+// Checks EffectRandom: a seed always gives the same sequence, bounded
+// draws stay in their range for awkward ranges, and the draws that would
+// bias a range towards its low values are thrown away, and only those.
+//
+//   pio test -e native -f test_effect_random -v
+#include <unity.h>
+#include <EffectEngine.h>
+
+const uint32_t Draws = 100000;
+
+// Lemire's method spelled out: a draw is kept once the low half of its
+// product is at or above 2^32 mod range. Returns the value and how many
+// draws it took.
+static uint32_t referenceBelow(EffectRandom& random, uint32_t range, uint32_t& draws) {
+    const uint32_t threshold = (uint32_t)((1ULL << 32) % range);
+    draws = 0;
+    for (;;) {
+        const uint64_t product = (uint64_t)random.Next() * range;
+        draws++;
+        if ((uint32_t)product >= threshold) {
+            return (uint32_t)(product >> 32);
+        }
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_seed_gives_a_fixed_sequence(void) {
+    // xorshift32 with shifts 13, 17 and 5
+    EffectRandom random(12345);
+    TEST_ASSERT_EQUAL_HEX32(0xc6e5747a, random.Next());
+    TEST_ASSERT_EQUAL_HEX32(0x652a09af, random.Next());
+    TEST_ASSERT_EQUAL_HEX32(0xa7e08fa0, random.Next());
+    TEST_ASSERT_EQUAL_HEX32(0x748e41ea, random.Next());
+    TEST_ASSERT_EQUAL_HEX32(0x2ad8a9d3, random.Next());
+
+    // seeding again starts it over, bounded draws included
+    EffectRandom first(777);
+    EffectRandom second(1);
+    second.Seed(777);
+    for (uint32_t draw = 0; draw < 1000; draw++) {
+        TEST_ASSERT_EQUAL_UINT32(first.Between(-50, 50), second.Between(-50, 50));
+    }
+}
+
+void test_zero_seed_still_runs(void) {
+    // zero would stick at zero, it is taken as one
+    EffectRandom zero(0);
+    EffectRandom one(1);
+    TEST_ASSERT_EQUAL_UINT32(270369, one.Next());
+    TEST_ASSERT_EQUAL_UINT32(270369, zero.Next());
+    TEST_ASSERT_NOT_EQUAL(0, zero.Next());
+}
+
+void test_range_of_three(void) {
+    EffectRandom random(42);
+    uint32_t counts[3] = { 0 };
+    for (uint32_t draw = 0; draw < Draws; draw++) {
+        const uint32_t value = random.Below(3);
+        TEST_ASSERT_TRUE(value < 3);
+        counts[value]++;
+    }
+    // each within a few standard deviations of a third
+    for (uint8_t value = 0; value < 3; value++) {
+        TEST_ASSERT_TRUE(counts[value] > Draws / 3 - 900 && counts[value] < Draws / 3 + 900);
+    }
+}
+
+void test_range_just_over_half(void) {
+    // 2^32 mod 0x80000001 is 0x7fffffff, so nearly half of all draws land
+    // where they would favour the low values and have to be thrown away
+    const uint32_t range = 0x80000001;
+    EffectRandom random(2024);
+    EffectRandom reference(2024);
+    uint32_t upperHalf = 0;
+    uint32_t rejected = 0;
+    for (uint32_t draw = 0; draw < Draws; draw++) {
+        uint32_t draws;
+        const uint32_t expected = referenceBelow(reference, range, draws);
+        const uint32_t value = random.Below(range);
+        TEST_ASSERT_EQUAL_UINT32(expected, value);
+        TEST_ASSERT_TRUE(value < range);
+        rejected += draws - 1;
+        if (value >= range / 2) {
+            upperHalf++;
+        }
+    }
+    // rejections take further draws from the same sequence, so the two
+    // are still in step
+    TEST_ASSERT_EQUAL_UINT32(reference.Next(), random.Next());
+    TEST_ASSERT_TRUE(rejected > Draws * 8 / 10 && rejected < Draws * 12 / 10);
+    TEST_ASSERT_TRUE(upperHalf > Draws / 2 - 1500 && upperHalf < Draws / 2 + 1500);
+}
+
+void test_ranges_that_divide_evenly_never_reject(void) {
+    // 2^32 mod a power of two is 0, every draw is kept
+    const uint32_t ranges[] = { 1, 2, 256, 0x80000000 };
+    for (size_t index = 0; index < sizeof(ranges) / sizeof(ranges[0]); index++) {
+        EffectRandom random(99);
+        EffectRandom reference(99);
+        for (uint32_t draw = 0; draw < 1000; draw++) {
+            TEST_ASSERT_TRUE(random.Below(ranges[index]) < ranges[index]);
+            reference.Next();
+        }
+        TEST_ASSERT_EQUAL_UINT32(reference.Next(), random.Next());
+    }
+}
+
+void test_between_bounds(void) {
+    EffectRandom random(7);
+    bool sawLow = false;
+    bool sawHigh = false;
+    for (uint32_t draw = 0; draw < 10000; draw++) {
+        const int32_t value = random.Between(-3, 4);
+        TEST_ASSERT_TRUE(value >= -3 && value < 4);
+        sawLow |= value == -3;
+        sawHigh |= value == 3;
+    }
+    TEST_ASSERT_TRUE(sawLow && sawHigh);
+
+    // as random(low, high), an empty range is low
+    TEST_ASSERT_EQUAL_INT32(5, random.Between(5, 5));
+    TEST_ASSERT_EQUAL_INT32(5, random.Between(5, 2));
+    // the widest range there is
+    const int32_t value = random.Between(INT32_MIN, INT32_MAX);
+    TEST_ASSERT_TRUE(value < INT32_MAX);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_seed_gives_a_fixed_sequence);
+    RUN_TEST(test_zero_seed_still_runs);
+    RUN_TEST(test_range_of_three);
+    RUN_TEST(test_range_just_over_half);
+    RUN_TEST(test_ranges_that_divide_evenly_never_reject);
+    RUN_TEST(test_between_bounds);
+    return UNITY_END();
+}
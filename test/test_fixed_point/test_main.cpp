@@ -0,0 +1,138 @@
+// Checks the integer blend and easing kernels in ColorMath.h produce the
+// same colours as the float RgbColor::LinearBlend and NeoEase path they
+// replaced, to within one step of rounding, that the 16 bit blend the
+// frame buffer uses is as close, and that the word at a time
+// DarkenChannels matches a plain saturating subtract exactly.
+#include <unity.h>
+#include <ColorMath.h>
+#include <NeoPixelAnimator.h>
+
+#include <cstdlib>
+
+// a spread of progress values, including both ends
+static uint32_t progressAt(uint32_t step, uint32_t steps) {
+    return (uint64_t)step * Q16One / steps;
+}
+
+static void checkEase(EaseFunction curve) {
+    EaseTable table(curve);
+    for (uint32_t progress = 0; progress <= Q16One; progress++) {
+        float expected = curve(progress / (float)Q16One) * Q16One;
+        float difference = table.Ease(progress) - expected;
+        // half a colour step over the full 0-255 range
+        TEST_ASSERT_TRUE_MESSAGE(fabsf(difference) <= Q16One / 512, "ease table strays from curve");
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_blend_matches_float(void) {
+    const uint32_t steps = 200;
+    for (int left = 0; left < 256; left++) {
+        for (int right = 0; right < 256; right++) {
+            for (uint32_t step = 0; step <= steps; step++) {
+                uint32_t weight = progressAt(step, steps);
+                RgbColor expected = RgbColor::LinearBlend(RgbColor(left, right, left),
+                    RgbColor(right, left, 0), weight / (float)Q16One);
+                RgbColor actual = BlendColor(RgbColor(left, right, left), RgbColor(right, left, 0), weight);
+
+                TEST_ASSERT_UINT8_WITHIN(1, expected.R, actual.R);
+                TEST_ASSERT_UINT8_WITHIN(1, expected.G, actual.G);
+                TEST_ASSERT_UINT8_WITHIN(1, expected.B, actual.B);
+            }
+        }
+    }
+}
+
+void test_blend_ends_exactly(void) {
+    for (int left = 0; left < 256; left++) {
+        for (int right = 0; right < 256; right++) {
+            TEST_ASSERT_EQUAL_UINT8(left, BlendColor(RgbColor(left), RgbColor(right), 0).R);
+            TEST_ASSERT_EQUAL_UINT8(right, BlendColor(RgbColor(left), RgbColor(right), Q16One).R);
+        }
+    }
+}
+
+void test_ease_tables_match_float(void) {
+    checkEase(NeoEase::Linear);
+    checkEase(NeoEase::CubicIn);
+    checkEase(NeoEase::CubicOut);
+    checkEase(NeoEase::QuadraticInOut);
+    checkEase(NeoEase::CubicInOut);
+    checkEase(NeoEase::QuarticInOut);
+    checkEase(NeoEase::QuinticInOut);
+    checkEase(NeoEase::SinusoidalInOut);
+}
+
+void test_eased_blend_matches_float(void) {
+    // the basic pattern's full per pixel path
+    EaseTable table(NeoEase::CubicOut);
+    const uint32_t steps = 1000;
+    for (int left = 0; left < 256; left += 3) {
+        for (int right = 0; right < 256; right += 5) {
+            for (uint32_t step = 0; step <= steps; step++) {
+                uint32_t progress = progressAt(step, steps);
+                RgbColor expected = RgbColor::LinearBlend(RgbColor(left), RgbColor(right),
+                    NeoEase::CubicOut(progress / (float)Q16One));
+                RgbColor actual = BlendColor(RgbColor(left), RgbColor(right), table.Ease(progress));
+
+                TEST_ASSERT_UINT8_WITHIN(1, expected.R, actual.R);
+            }
+        }
+    }
+}
+
+void test_blend16_matches_float(void) {
+    const uint32_t steps = 1000;
+    for (uint32_t left = 0; left < 65536; left += 257 * 3) {
+        for (uint32_t right = 0; right < 65536; right += 257 * 5) {
+            for (uint32_t step = 0; step <= steps; step++) {
+                uint32_t weight = progressAt(step, steps);
+                float expected = left + ((float)right - left) * weight / Q16One;
+                float actual = BlendChannel(left, right, weight);
+                // the weight loses its bottom bit and the result is floored
+                TEST_ASSERT_TRUE_MESSAGE(fabsf(actual - expected) <= 2.0f, "16 bit blend strays from float");
+            }
+            TEST_ASSERT_EQUAL_UINT16(left, BlendChannel(left, right, 0));
+            TEST_ASSERT_EQUAL_UINT16(right, BlendChannel(left, right, Q16One));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(65535, BlendChannel(0, 65535, Q16One));
+    TEST_ASSERT_EQUAL_UINT16(0, BlendChannel(65535, 0, Q16One));
+}
+
+void test_darken_matches_saturating_subtract(void) {
+    // odd offsets and lengths so the single channel head and tail are covered too
+    uint16_t channels[67];
+    for (uint32_t darkenBy = 0; darkenBy < 65536; darkenBy += 97) {
+        for (size_t offset = 0; offset < 2; offset++) {
+            for (size_t index = 0; index < 67; index++) {
+                channels[index] = (index * 7919 + darkenBy * 11) & 0xffff;
+            }
+            DarkenChannels(channels + offset, 67 - offset, darkenBy);
+
+            for (size_t index = 0; index < 67; index++) {
+                uint16_t expected = (index * 7919 + darkenBy * 11) & 0xffff;
+                if (index >= offset) {
+                    expected = (expected > darkenBy) ? expected - darkenBy : 0;
+                }
+                TEST_ASSERT_EQUAL_UINT16(expected, channels[index]);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_blend_matches_float);
+    RUN_TEST(test_blend_ends_exactly);
+    RUN_TEST(test_ease_tables_match_float);
+    RUN_TEST(test_eased_blend_matches_float);
+    RUN_TEST(test_blend16_matches_float);
+    RUN_TEST(test_darken_matches_saturating_subtract);
+    return UNITY_END();
+}
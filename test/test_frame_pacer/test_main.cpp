@@ -0,0 +1,92 @@
+// Checks FramePacer's deadline grid: frames on time stay on it, a late
+// frame doesn't move it, whole intervals that were missed are counted as
+// dropped and skipped, and none of it minds micros() wrapping.
+//
+//   pio test -e native -f test_frame_pacer -v
+#include <unity.h>
+#include <FramePacer.h>
+
+const uint16_t TestFps = 60;
+const uint32_t Interval = 1000000UL / TestFps;
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_first_frame_is_due_at_once(void) {
+    FramePacer pacer(TestFps);
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.timeUntilDue(12345));
+    pacer.frameStarted(12345);
+    TEST_ASSERT_EQUAL_UINT32(Interval, pacer.timeUntilDue(12345));
+    TEST_ASSERT_EQUAL_UINT32(Interval - 1000, pacer.timeUntilDue(12345 + 1000));
+}
+
+void test_on_time_frames_stay_on_the_grid(void) {
+    FramePacer pacer(TestFps);
+    const uint32_t start = 1000;
+    pacer.frameStarted(start);
+    for (uint32_t frame = 1; frame <= 600; frame++) {
+        // a little early or late each time doesn't drift the deadline
+        const uint32_t now = start + frame * Interval + ((frame % 3) * 200) - 200;
+        pacer.frameStarted(now);
+        TEST_ASSERT_EQUAL_UINT32(start + (frame + 1) * Interval - now, pacer.timeUntilDue(now));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.getDroppedFrames());
+}
+
+void test_one_overrun_keeps_the_grid(void) {
+    FramePacer pacer(TestFps);
+    pacer.frameStarted(0);
+    // the second frame starts most of an interval late, still the same slot
+    const uint32_t late = Interval + Interval - 100;
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.timeUntilDue(late));
+    pacer.frameStarted(late);
+    TEST_ASSERT_EQUAL_UINT32(100, pacer.timeUntilDue(late));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.getDroppedFrames());
+}
+
+void test_missed_intervals_are_dropped(void) {
+    FramePacer pacer(TestFps);
+    pacer.frameStarted(0);
+    // three whole intervals after the frame was due, three are skipped and
+    // the one started now is the fourth slot on
+    const uint32_t now = Interval + 3 * Interval + 500;
+    pacer.frameStarted(now);
+    TEST_ASSERT_EQUAL_UINT32(3, pacer.getDroppedFrames());
+    TEST_ASSERT_EQUAL_UINT32(5 * Interval - now, pacer.timeUntilDue(now));
+
+    // and back on time from there counts nothing more
+    pacer.frameStarted(5 * Interval);
+    TEST_ASSERT_EQUAL_UINT32(3, pacer.getDroppedFrames());
+}
+
+void test_micros_wrap(void) {
+    FramePacer pacer(TestFps);
+    const uint32_t start = 0xffffffffUL - Interval / 2;
+    pacer.frameStarted(start);
+    // the deadline is past the wrap, it is still in the future
+    TEST_ASSERT_EQUAL_UINT32(Interval - 10, pacer.timeUntilDue(start + 10));
+    TEST_ASSERT_EQUAL_UINT32(Interval / 2 - 100, pacer.timeUntilDue(99));
+
+    const uint32_t next = start + Interval;
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.timeUntilDue(next));
+    pacer.frameStarted(next);
+    TEST_ASSERT_EQUAL_UINT32(Interval, pacer.timeUntilDue(next));
+
+    // missing frames across the wrap counts them the same
+    pacer.frameStarted(next + 3 * Interval);
+    TEST_ASSERT_EQUAL_UINT32(2, pacer.getDroppedFrames());
+    TEST_ASSERT_EQUAL_UINT32(Interval, pacer.timeUntilDue(next + 3 * Interval));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_is_due_at_once);
+    RUN_TEST(test_on_time_frames_stay_on_the_grid);
+    RUN_TEST(test_one_overrun_keeps_the_grid);
+    RUN_TEST(test_missed_intervals_are_dropped);
+    RUN_TEST(test_micros_wrap);
+    return UNITY_END();
+}
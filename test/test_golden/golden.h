@@ -0,0 +1,88 @@
+#ifndef GOLDEN_FRAMES_H
+#define GOLDEN_FRAMES_H
+
+// Stored golden frames, refresh them after an intended change to how an
+// effect looks by running the suite built with -D GOLDEN_RECORD and
+// pasting the table it prints over the one below.
+
+#include <cstdint>
+#include <cstddef>
+
+// how many 8 bit steps a byte sent to the strip may be off by, 0 also
+// requires the 16 bit frame to hash the same
+#ifndef GOLDEN_TOLERANCE
+#define GOLDEN_TOLERANCE 0
+#endif
+const int GoldenTolerance = GOLDEN_TOLERANCE;
+
+const uint16_t GoldenPixelCount = 45;
+const uint32_t GoldenSeed = 1;
+const uint32_t GoldenFrameMs = 16; // 60 fps
+
+struct GoldenFrame {
+    const char* scenario; // effect name, or what a transition goes between
+    uint32_t frame;       // frames after the switch
+    uint64_t frameHash;   // FNV-1a of the 16 bit frame, pixel by pixel
+    const char* wire;     // bytes sent to the strip, GRB, in hex
+};
+
+const GoldenFrame goldenFrames[] = {
+    { "Basic Pattern", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Basic Pattern", 15, 0x40b892e4d0c66f82ULL,
+      "020000000000000000000000000000000000000203000001000000000000000101000000000000000000000000000000000000000000010100000000000000000000000000000000000000000000000000000000000000000003000000000000000000000000000000000000000000000000000000000100000000000000000000000000000000" },
+    { "Basic Pattern", 120, 0x2c38bff6fe3f6f90ULL,
+      "12000000080100000001000000000000020d001721030120000000080e12001c1e0a00010000000301031507020802120000000000001e200000010008180000000301000e01000000000009011400000006121c000000050032080014120501010101000100000101011f050000000503070908000017090401060200071d012e080403021304" },
+    { "Basic Pattern", 600, 0x8f865233a2a2950bULL,
+      "1201001627000000120119180708180205100113330010130513130e09052a020516000a0103011e081b0b03031a1815140e06090100040b09032e0109030332180b1c172120010d1701050a03110513000514221019051c21250203010d2610012706130001102b0a2b291200142300090e20170109030508310003000a042210030909150331" },
+    { "Fade In Fade Out", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Fade In Fade Out", 15, 0x30bf6db4ce8afa32ULL,
+      "000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200000200" },
+    { "Fade In Fade Out", 120, 0x1ef2b5d5e8f3ca8bULL,
+      "000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100000100" },
+    { "Fade In Fade Out", 600, 0x55fba8881956dbd3ULL,
+      "000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409000409" },
+    { "Random Change", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Random Change", 15, 0xded1fc9c189e767fULL,
+      "000800000000000000000021000000000000210014000000000000000021000000000000000d00000000000000000009212100000000000000000000000000000c210000000000000000000000000000000000000000000000001809000021000b0000000000000000000600001121060000070005000000001a1400000000000006000c000000" },
+    { "Random Change", 120, 0x2c6d2a7d7624d882ULL,
+      "00210001210021000b0000210d0021130401030121210006210010210700000000100a0419002121001c00000007002100211621000000210007210007210000210000090c0005210e00210321000b0a0000000000052100000d2101002100000300210000000a00210200212107002100000021210000001421011e0021000000010021002104" },
+    { "Random Change", 600, 0x0265dad7933d1b17ULL,
+      "070021001c21210004210b000021042111001a0100211d0018210000210910002100012100211a211a0004002100012100002107002121001400210c1a0300210300032100112100002100000e2100210000211300211a21000000211e2021000021012103000011210021032100051e00210a21000821002121000001210c00211d2100000121" },
+    { "Rotating Loop", 1, 0x40ba04c056525bbdULL,
+      "000000000300000e00002100003f00006800009b00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop", 15, 0x40ba04c056525bbdULL,
+      "000000000000000000000300000e00002100003f00006800009b00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop", 120, 0x40ba04c056525bbdULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000300000e00002100003f00006800009b00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop", 600, 0x40ba04c056525bbdULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000300000e00002100003f00006800009b00000000000000000000000000000000000000000000000000000000" },
+    { "Bounce", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Bounce", 15, 0x4b21dbf4ae51c173ULL,
+      "003600000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Bounce", 120, 0x71d8d7cf01ed4eb3ULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000003600" },
+    { "Bounce", 600, 0x313bf9c06452ad99ULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000100000600002500003600" },
+    { "Fancy Rotating Loop", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Fancy Rotating Loop", 15, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Fancy Rotating Loop", 120, 0x4648c488c1809159ULL,
+      "000000000000000000000000000000000000000000000200000400000800000d00001300001b00002500003000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Fancy Rotating Loop", 600, 0xb469864f54cbe4bfULL,
+      "0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000201000404000807000d0c001312001b1900252200302d00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop to Basic Pattern", 1, 0x04ad4c90c59aaeddULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000300000e00002100003f00006800009b00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop to Basic Pattern", 15, 0x714c59b7e8365123ULL,
+      "000000000000000000000000000000000000000000000000000000000000000000000000000100000400000b00001100001c00003800000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" },
+    { "Rotating Loop to Basic Pattern", 120, 0xd4b6029987daa349ULL,
+      "000f120a160000000900341e1100020000000000000105010100000000000000000006020200010001010e0c2a000101000002003509280826050001350e120001000000000004070000000002010002000a1503000000000000000000090a1f090d050e020c0000000e0800020d01000000120113120b00010c0400000000000011001f090601" },
+    { "Rotating Loop to Basic Pattern", 600, 0xb6fb9e00bbd52693ULL,
+      "020213270e16000501241b00020009070e0314010110240027000f03240e020f29000b11030e01070a1b03040b13131921340b05010c092c023120030323090b28180b1211030f1801091711000613040515040518130f020808030002151520271501002f13332f163112090b2902090300190025001d11310b080007040816110f140e0b050a" },
+};
+
+#endif
@@ -0,0 +1,193 @@
+// Golden frames for every effect. Each one runs from a fixed seed on the
+// virtual clock and chosen frames are checked against golden.h, so a
+// rewrite that changes what an effect looks like fails here rather than
+// on the mirror.
+//
+//   pio test -e native -f test_golden -v
+//
+// By default a frame has to match exactly, the 16 bit frame the effect drew
+// by its hash and the bytes sent to the strip one for one. A fixed point
+// rewrite that only moves the rounding can be checked with a tolerance
+// instead, where only the strip bytes are compared, each to within that
+// many steps:
+//
+//   PLATFORMIO_BUILD_FLAGS="-D GOLDEN_TOLERANCE=2" pio test -e native -f test_golden
+//
+// After an intended change, build with -D GOLDEN_RECORD and the suite
+// prints a new table for golden.h in place of checking the old one.
+#include <unity.h>
+#include <LEDController.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "golden.h"
+
+// frames after switching to the effect that are checked, the first one,
+// a quarter second in, part way through a transition, then two seconds
+// and ten seconds in
+const uint32_t Checkpoints[] = { 1, 15, 120, 600 };
+const uint32_t CheckpointCount = sizeof(Checkpoints) / sizeof(Checkpoints[0]);
+// how long the effect being switched away from runs before a transition
+const uint32_t TransitionWarmUpFrames = 60;
+
+// FNV-1a over every channel, in pixel order rather than memory order so
+// how the frame stores a rotation doesn't change it
+static uint64_t hashFrame(const FrameBuffer& frame) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint16_t pixel = 0; pixel < frame.PixelCount(); pixel++) {
+        const FrameColor color = frame.GetPixelColor16(pixel);
+        const uint16_t channels[3] = { color.R, color.G, color.B };
+        for (uint8_t channel = 0; channel < 3; channel++) {
+            hash = (hash ^ (channels[channel] & 0xff)) * 1099511628211ULL;
+            hash = (hash ^ (channels[channel] >> 8)) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+static uint8_t hexDigit(char digit) {
+    return (digit <= '9') ? digit - '0' : digit - 'a' + 10;
+}
+
+static const GoldenFrame* findGolden(const char* scenario, uint32_t frame) {
+    for (size_t index = 0; index < sizeof(goldenFrames) / sizeof(goldenFrames[0]); index++) {
+        if (strcmp(goldenFrames[index].scenario, scenario) == 0 && goldenFrames[index].frame == frame) {
+            return &goldenFrames[index];
+        }
+    }
+    return nullptr;
+}
+
+static void checkFrame(const char* scenario, uint32_t frameNumber) {
+    const uint64_t hash = hashFrame(getFrame());
+    const HostWire& wire = hostWire();
+
+#ifdef GOLDEN_RECORD
+    printf("    { \"%s\", %u, 0x%016llxULL,\n      \"", scenario, (unsigned)frameNumber, (unsigned long long)hash);
+    for (size_t index = 0; index < wire.size; index++) {
+        printf("%02x", wire.data[index]);
+    }
+    printf("\" },\n");
+#else
+    char message[200];
+    const GoldenFrame* golden = findGolden(scenario, frameNumber);
+    snprintf(message, sizeof(message), "%s frame %u: no golden frame stored", scenario, (unsigned)frameNumber);
+    TEST_ASSERT_NOT_NULL_MESSAGE(golden, message);
+
+    snprintf(message, sizeof(message), "%s frame %u: wire is %u bytes, golden has %u",
+        scenario, (unsigned)frameNumber, (unsigned)wire.size, (unsigned)(strlen(golden->wire) / 2));
+    TEST_ASSERT_EQUAL_MESSAGE(strlen(golden->wire), wire.size * 2, message);
+
+    for (size_t index = 0; index < wire.size; index++) {
+        const uint8_t expected = (hexDigit(golden->wire[index * 2]) << 4) | hexDigit(golden->wire[index * 2 + 1]);
+        snprintf(message, sizeof(message), "%s frame %u: pixel %u channel %u is %u, golden %u",
+            scenario, (unsigned)frameNumber, (unsigned)(index / 3), (unsigned)(index % 3),
+            wire.data[index], expected);
+        TEST_ASSERT_TRUE_MESSAGE(abs(wire.data[index] - expected) <= GoldenTolerance, message);
+    }
+
+    if (GoldenTolerance == 0) {
+        snprintf(message, sizeof(message), "%s frame %u: frame hash %016llx, golden %016llx",
+            scenario, (unsigned)frameNumber, (unsigned long long)hash, (unsigned long long)golden->frameHash);
+        TEST_ASSERT_TRUE_MESSAGE(hash == golden->frameHash, message);
+    }
+#endif
+}
+
+static void runFrame(int animation) {
+    hostAdvanceMillis(GoldenFrameMs);
+    animationSelector(animation);
+    showFrame();
+}
+
+// Switches from one effect to another and checks the frames after it.
+// Every scenario starts from a dark strip, the same seed and the same
+// place in the second, so they don't depend on what ran before them.
+static void runScenario(const char* scenario, int from, int to, uint16_t transition) {
+    if (getPixelCount() != GoldenPixelCount) {
+        TEST_IGNORE_MESSAGE("golden frames are stored for the default pixel count only");
+    }
+
+    setTransitionTime(0);
+    animationSelector(0);
+    showFrame();
+    hostAdvanceMillis(1000 - millis() % 1000);
+    SetRandomSeed(GoldenSeed);
+
+    if (from != 0) {
+        for (uint32_t frame = 0; frame < TransitionWarmUpFrames; frame++) {
+            runFrame(from);
+        }
+    }
+
+    setTransitionTime(transition);
+    uint32_t checkpoint = 0;
+    for (uint32_t frame = 1; checkpoint < CheckpointCount; frame++) {
+        runFrame(to);
+        if (frame == Checkpoints[checkpoint]) {
+            checkFrame(scenario, frame);
+            checkpoint++;
+        }
+    }
+}
+
+static void runEffect(int animation) {
+    runScenario(getEffectName(animation), 0, animation, 0);
+}
+
+void setUp(void) {
+    // the default curve, but dithering carries each frame's rounding into
+    // the next, so without it a frame on the wire depends only on the frame
+    OutputSettings settings = getOutputSettings();
+    settings.dither = false;
+    setOutputSettings(settings);
+    setEffectSpeed(100);
+    changeCylonColour(HtmlColor(0x7f0000));
+}
+
+void tearDown(void) {
+}
+
+void test_basic_animation(void) {
+    runEffect(1);
+}
+
+void test_fade_in_fade_out(void) {
+    runEffect(2);
+}
+
+void test_random_change(void) {
+    runEffect(3);
+}
+
+void test_rotating_loop(void) {
+    runEffect(4);
+}
+
+void test_cylon(void) {
+    runEffect(5);
+}
+
+void test_fun_rotating_loop(void) {
+    runEffect(6);
+}
+
+void test_transition(void) {
+    // the cross fade blends in the output stage, the frame is the new effect
+    runScenario("Rotating Loop to Basic Pattern", 4, 1, 500);
+}
+
+int main(int argc, char** argv) {
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_basic_animation);
+    RUN_TEST(test_fade_in_fade_out);
+    RUN_TEST(test_random_change);
+    RUN_TEST(test_rotating_loop);
+    RUN_TEST(test_cylon);
+    RUN_TEST(test_fun_rotating_loop);
+    RUN_TEST(test_transition);
+    return UNITY_END();
+}
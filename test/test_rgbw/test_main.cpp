@@ -0,0 +1,90 @@
+// Checks the output stage on an RGBW strip: the light red, green and blue
+// share goes to the white LED, the rest stays on the colour LEDs, and the
+// bytes go out in the strip's order with white last. Only means anything
+// in a build for RGBW strips, the native_rgbw environment.
+//
+//   pio test -e native_rgbw -f test_rgbw -v
+#include <unity.h>
+#include <LEDController.h>
+#include <OutputStage.h>
+
+const uint16_t TestPixels = 4;
+
+static uint16_t channels[TestPixels * FrameBuffer::ChannelsPerPixel];
+static uint8_t wire[TestPixels * Strip::BytesPerPixel];
+
+static void applyColor(OutputStage& stage, const FrameColor& color) {
+    FrameBuffer frame(channels, TestPixels);
+    frame.Fill(color, 0, TestPixels);
+    stage.Apply(frame, wire, 0, TestPixels);
+}
+
+static void assertWire(uint8_t red, uint8_t green, uint8_t blue, uint8_t white) {
+    for (uint16_t pixel = 0; pixel < TestPixels; pixel++) {
+        const uint8_t* bytes = wire + pixel * Strip::BytesPerPixel;
+        TEST_ASSERT_EQUAL_UINT8(red, bytes[FrameBuffer::Red]);
+        TEST_ASSERT_EQUAL_UINT8(green, bytes[FrameBuffer::Green]);
+        TEST_ASSERT_EQUAL_UINT8(blue, bytes[FrameBuffer::Blue]);
+        TEST_ASSERT_EQUAL_UINT8(white, bytes[Strip::White]);
+    }
+}
+
+void setUp(void) {
+    if (!Strip::HasWhite) {
+        TEST_IGNORE_MESSAGE("built for RGB strips, run with -e native_rgbw");
+    }
+}
+
+void tearDown(void) {
+}
+
+void test_white_comes_from_the_white_led(void) {
+    OutputStage stage;
+    OutputSettings linear = { 1.0f, 255, RgbColor(255, 255, 255), false };
+    stage.SetSettings(linear);
+
+    applyColor(stage, FrameColor(65535, 65535, 65535));
+    assertWire(0, 0, 0, 255);
+
+    // a pure colour has nothing in common to move
+    applyColor(stage, FrameColor(65535, 0, 0));
+    assertWire(255, 0, 0, 0);
+
+    // a pastel is the colour on top of white
+    applyColor(stage, RgbColor(255, 128, 64));
+    assertWire(191, 64, 0, 64);
+}
+
+void test_white_follows_the_curve(void) {
+    // brightness and gamma are applied before white is taken out, so the
+    // white LED gives the same light the three would have
+    OutputStage stage;
+    OutputSettings dimmed = { 1.0f / 0.45f, 128, RgbColor(255, 255, 255), false };
+    stage.SetSettings(dimmed);
+
+    applyColor(stage, RgbColor(200, 200, 200));
+    const uint8_t expected = (stage.Correct(0, 200 * 257) + 0x80) >> 8;
+    assertWire(0, 0, 0, expected);
+}
+
+void test_strip_sends_four_bytes_a_pixel(void) {
+    fillPixels(RgbColor(255, 255, 255), 0, getPixelCount());
+    showFrame();
+
+    const HostWire& sent = hostWire();
+    TEST_ASSERT_EQUAL(getPixelCount() * 4, sent.size);
+    for (uint16_t pixel = 0; pixel < getPixelCount(); pixel++) {
+        TEST_ASSERT_EQUAL_UINT8(0, sent.data[pixel * 4 + FrameBuffer::Red]);
+        TEST_ASSERT_EQUAL_UINT8(255, sent.data[pixel * 4 + Strip::White]);
+    }
+}
+
+int main(int argc, char** argv) {
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_white_comes_from_the_white_led);
+    RUN_TEST(test_white_follows_the_curve);
+    RUN_TEST(test_strip_sends_four_bytes_a_pixel);
+    return UNITY_END();
+}
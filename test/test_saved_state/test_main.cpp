@@ -0,0 +1,212 @@
+// Checks what is saved to NVS: a record that fails its CRC or is from
+// another version is never read back, a good one comes back as it was
+// saved, settings are only written once they have stopped changing, and a
+// new strip layout is written from loop() rather than the web server.
+//
+//   pio test -e native -f test_saved_state -v
+#include <unity.h>
+#include <LEDController.h>
+#include <SavedState.h>
+#include <Preferences.h>
+
+// where SavedState.cpp keeps the record
+const char* RecordNamespace = "state";
+const char* RecordKey = "saved";
+// what saveStateWhenQuiet() waits for, and a little over
+const uint32_t QuietPeriod = 5000; // ms
+const uint32_t PastQuietPeriod = QuietPeriod + 100;
+
+static SavedState testState() {
+    SavedState state;
+    memset(&state, 0, sizeof(state));
+    state.effect = 4;
+    state.brightness = 90;
+    state.dither = 1;
+    state.colour = 0x102030;
+    state.whiteBalance = 0xfff0e0;
+    state.speed = 150;
+    state.transition = 750;
+    state.gamma = 2.5f;
+    for (uint8_t animation = 0; animation < SavedEffectCount; animation++) {
+        state.effectSpeeds[animation] = 100 + animation;
+    }
+    return state;
+}
+
+static size_t readRecord(SavedState& record) {
+    Preferences preferences;
+    preferences.begin(RecordNamespace, true);
+    size_t length = preferences.getBytes(RecordKey, &record, sizeof(record));
+    preferences.end();
+    return length;
+}
+
+static void writeRecord(const void* record, size_t length) {
+    Preferences preferences;
+    preferences.begin(RecordNamespace, false);
+    preferences.putBytes(RecordKey, record, length);
+    preferences.end();
+}
+
+static bool recordSaved() {
+    Preferences preferences;
+    preferences.begin(RecordNamespace, true);
+    bool saved = preferences.isKey(RecordKey);
+    preferences.end();
+    return saved;
+}
+
+static void setBrightness(uint8_t brightness) {
+    postCommand(Command_SetBrightness, brightness);
+    applyCommands();
+}
+
+void setUp(void) {
+    // anything a test before left changing is written out, then forgotten
+    saveStateWhenQuiet();
+    hostAdvanceMillis(PastQuietPeriod);
+    saveStateWhenQuiet();
+    hostClearPreferences();
+}
+
+void tearDown(void) {
+}
+
+void test_crc32_check_value(void) {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xcbf43926, crc32((const uint8_t*)check, 9));
+}
+
+void test_round_trip(void) {
+    const SavedState state = testState();
+    TEST_ASSERT_TRUE(saveSavedState(state));
+
+    SavedState loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    TEST_ASSERT_TRUE(loadSavedState(loaded));
+    TEST_ASSERT_EQUAL_MEMORY(&state.effect, &loaded.effect, offsetof(SavedState, crc) - offsetof(SavedState, effect));
+}
+
+void test_corrupted_byte_is_rejected(void) {
+    TEST_ASSERT_TRUE(saveSavedState(testState()));
+    SavedState record;
+    TEST_ASSERT_EQUAL(sizeof(record), readRecord(record));
+
+    // as a write cut short by losing power would leave it
+    ((uint8_t*)&record)[offsetof(SavedState, speed)] ^= 0x04;
+    writeRecord(&record, sizeof(record));
+
+    SavedState loaded = testState();
+    loaded.brightness = 7;
+    TEST_ASSERT_FALSE(loadSavedState(loaded));
+    // and what was passed in is left alone
+    TEST_ASSERT_EQUAL_UINT8(7, loaded.brightness);
+}
+
+void test_version_1_record_is_rejected(void) {
+    // a version 1 record is shorter, without the effect speeds
+    TEST_ASSERT_TRUE(saveSavedState(testState()));
+    SavedState record;
+    readRecord(record);
+    const size_t version1Size = offsetof(SavedState, effectSpeeds) + sizeof(uint32_t);
+    record.version = 1;
+    uint32_t crc = crc32((const uint8_t*)&record, offsetof(SavedState, effectSpeeds));
+    memcpy((uint8_t*)&record + offsetof(SavedState, effectSpeeds), &crc, sizeof(crc));
+    writeRecord(&record, version1Size);
+
+    SavedState loaded;
+    TEST_ASSERT_FALSE(loadSavedState(loaded));
+
+    // nor is one the right size with a good CRC, only the version is wrong
+    record = testState();
+    record.version = 1;
+    record.crc = crc32((const uint8_t*)&record, offsetof(SavedState, crc));
+    writeRecord(&record, sizeof(record));
+    TEST_ASSERT_FALSE(loadSavedState(loaded));
+}
+
+void test_saved_only_after_the_quiet_period(void) {
+    setBrightness(123);
+    saveStateWhenQuiet();
+
+    hostAdvanceMillis(QuietPeriod - 100);
+    saveStateWhenQuiet();
+    TEST_ASSERT_FALSE(recordSaved());
+
+    hostAdvanceMillis(200);
+    saveStateWhenQuiet();
+    TEST_ASSERT_TRUE(recordSaved());
+
+    SavedState loaded;
+    TEST_ASSERT_TRUE(loadSavedState(loaded));
+    TEST_ASSERT_EQUAL_UINT8(123, loaded.brightness);
+}
+
+void test_not_saved_while_settings_keep_changing(void) {
+    // a slider moved every second for half a minute, each move starts the
+    // quiet period again
+    for (uint32_t second = 0; second < 30; second++) {
+        setBrightness(100 + second);
+        for (uint32_t step = 0; step < 10; step++) {
+            saveStateWhenQuiet();
+            hostAdvanceMillis(100);
+        }
+        TEST_ASSERT_FALSE(recordSaved());
+    }
+
+    hostAdvanceMillis(PastQuietPeriod);
+    saveStateWhenQuiet();
+    SavedState loaded;
+    TEST_ASSERT_TRUE(loadSavedState(loaded));
+    TEST_ASSERT_EQUAL_UINT8(129, loaded.brightness);
+}
+
+void test_layout_saved_from_loop_after_the_render_task(void) {
+    StripLayout layout = { 2, { { 5, 100 }, { 6, 200 } } };
+    StripLayout invalid = { 1, { { 5, 0 } } };
+    TEST_ASSERT_FALSE(setStripLayout(invalid));
+
+    // nothing is written from the web server, only once the render task
+    // has taken it and loop() gets to it
+    TEST_ASSERT_TRUE(setStripLayout(layout));
+    TEST_ASSERT_FALSE(saveRequestedLayout());
+    // and one layout at a time
+    TEST_ASSERT_FALSE(setStripLayout(layout));
+
+    applyCommands();
+    TEST_ASSERT_TRUE(saveRequestedLayout());
+    StripLayout loaded;
+    TEST_ASSERT_TRUE(loadStripLayout(loaded));
+    TEST_ASSERT_EQUAL_UINT8(2, loaded.segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(200, loaded.segments[1].count);
+    // saved once, the mirror restarts from here
+    TEST_ASSERT_FALSE(saveRequestedLayout());
+}
+
+void test_restored_at_boot(void) {
+    // saved before initStrip() in main(), as it would be from the last run
+    const SavedState state = testState();
+    TEST_ASSERT_EQUAL_INT(state.effect, getSelectedEffect());
+    TEST_ASSERT_EQUAL_UINT8(state.brightness, getOutputSettings().brightness);
+    TEST_ASSERT_EQUAL_FLOAT(state.gamma, getOutputSettings().gamma);
+    TEST_ASSERT_EQUAL_UINT16(state.speed, getEffectSpeed());
+    TEST_ASSERT_EQUAL_UINT16(state.transition, getTransitionTime());
+    TEST_ASSERT_EQUAL_UINT16(state.effectSpeeds[1], getEffectSpeed(1));
+    TEST_ASSERT_TRUE(getCylonColour() == RgbColor(0x10, 0x20, 0x30));
+}
+
+int main(int argc, char** argv) {
+    saveSavedState(testState());
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_restored_at_boot);
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_corrupted_byte_is_rejected);
+    RUN_TEST(test_version_1_record_is_rejected);
+    RUN_TEST(test_saved_only_after_the_quiet_period);
+    RUN_TEST(test_not_saved_while_settings_keep_changing);
+    RUN_TEST(test_layout_saved_from_loop_after_the_render_task);
+    return UNITY_END();
+}
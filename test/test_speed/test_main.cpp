@@ -0,0 +1,170 @@
+// Checks the effect speeds: the effect clock runs at the speed of every
+// effect times the speed of the one running, and changing either carries
+// the running effect on from where it is rather than setting it up again.
+//
+//   pio test -e native -f test_speed -v
+#include <unity.h>
+#include <LEDController.h>
+#include <EffectEngine.h>
+
+const uint32_t FrameMs = 16; // 60 fps
+const int RotatingLoop = 4;
+
+static void runFrames(int animation, uint32_t frames) {
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        hostAdvanceMillis(FrameMs);
+        animationSelector(animation);
+        showFrame();
+    }
+}
+
+// how far the rotating loop moves in a number of frames
+static uint16_t rotationSteps(uint32_t frames) {
+    const uint16_t before = getFrame().Offset();
+    runFrames(RotatingLoop, frames);
+    return (getFrame().Offset() + getPixelCount() - before) % getPixelCount();
+}
+
+static bool sameFrame(const uint16_t* channels, const FrameBuffer& frame) {
+    return memcmp(channels, frame.Channels(), frame.ChannelCount() * sizeof(uint16_t)) == 0;
+}
+
+void setUp(void) {
+    setEffectSpeed(100);
+    for (int animation = 0; animation < getEffectCount(); animation++) {
+        setEffectSpeed(animation, 100);
+    }
+    setTransitionTime(0);
+    animationSelector(0);
+}
+
+void tearDown(void) {
+}
+
+void test_clock_scales_by_both_speeds(void) {
+    EffectClock clock;
+    clock.Advance(0);
+    clock.SetSpeed(50);
+    clock.SetEffectSpeed(300);
+    clock.Advance(1000);
+    TEST_ASSERT_EQUAL_UINT32(1500, clock.Millis());
+
+    // what doesn't make a whole ms is carried, not lost
+    clock.SetSpeed(33);
+    clock.SetEffectSpeed(10);
+    for (uint32_t now = 1001; now <= 2000; now++) {
+        clock.Advance(now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1500 + 33, clock.Millis());
+}
+
+void test_speed_change_keeps_the_effect_running(void) {
+    // switching to an effect starts its rotation from nothing, setting it
+    // up again would too
+    runFrames(RotatingLoop, 30);
+    const uint32_t normalSteps = rotationSteps(30);
+    const uint16_t offset = getFrame().Offset();
+    TEST_ASSERT_TRUE(offset > 0);
+
+    setEffectSpeed(RotatingLoop, 200);
+    TEST_ASSERT_EQUAL_UINT16(200, getEffectSpeed(RotatingLoop));
+    runFrames(RotatingLoop, 1);
+    TEST_ASSERT_TRUE(getFrame().Offset() >= offset);
+
+    // and faster from here on, by as much as whole frames allow
+    TEST_ASSERT_TRUE(rotationSteps(30) > normalSteps);
+}
+
+void test_zero_speed_pauses_the_effect(void) {
+    runFrames(RotatingLoop, 30);
+    setEffectSpeed(RotatingLoop, 0);
+    runFrames(RotatingLoop, 1);
+
+    const FrameBuffer& frame = getFrame();
+    uint16_t* paused = new uint16_t[frame.ChannelCount()];
+    memcpy(paused, frame.Channels(), frame.ChannelCount() * sizeof(uint16_t));
+    const uint16_t offset = frame.Offset();
+
+    runFrames(RotatingLoop, 60);
+    TEST_ASSERT_EQUAL_UINT16(offset, frame.Offset());
+    TEST_ASSERT_TRUE(sameFrame(paused, frame));
+    delete[] paused;
+}
+
+void test_speed_stays_with_its_effect(void) {
+    setEffectSpeed(RotatingLoop, 0);
+    runFrames(RotatingLoop, 10);
+
+    // another effect runs at its own speed, and the paused one is still
+    // paused when it comes back
+    runFrames(1, 10);
+    TEST_ASSERT_EQUAL_UINT16(0, getEffectSpeed(RotatingLoop));
+    TEST_ASSERT_EQUAL_UINT16(100, getEffectSpeed(1));
+
+    runFrames(RotatingLoop, 10);
+    const uint16_t offset = getFrame().Offset();
+    runFrames(RotatingLoop, 30);
+    TEST_ASSERT_EQUAL_UINT16(offset, getFrame().Offset());
+}
+
+void test_command_sets_the_selected_effect(void) {
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffect, RotatingLoop));
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffectSpeed, 250));
+    applyCommands();
+
+    TEST_ASSERT_EQUAL_INT(RotatingLoop, getSelectedEffect());
+    TEST_ASSERT_EQUAL_UINT16(250, getEffectSpeed(RotatingLoop));
+    TEST_ASSERT_EQUAL_UINT16(100, getEffectSpeed(0));
+
+    postCommand(Command_SetEffect, 0);
+    applyCommands();
+}
+
+void test_commands_apply_in_the_order_sent(void) {
+    postCommand(Command_SetEffect, 1);
+    applyCommands();
+
+    // in one batch, the speed was sent while effect 1 was selected, so it
+    // is effect 1's, and of the run of speeds only the last counts
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffectSpeed, 300));
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffectSpeed, 150));
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffect, RotatingLoop));
+    applyCommands();
+
+    TEST_ASSERT_EQUAL_INT(RotatingLoop, getSelectedEffect());
+    TEST_ASSERT_EQUAL_UINT16(150, getEffectSpeed(1));
+    TEST_ASSERT_EQUAL_UINT16(100, getEffectSpeed(RotatingLoop));
+
+    postCommand(Command_SetEffect, 0);
+    applyCommands();
+}
+
+void test_command_ignores_unknown_effects(void) {
+    postCommand(Command_SetEffect, RotatingLoop);
+    applyCommands();
+
+    // neither before the effects nor the stream's slot after them
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffect, (uint32_t)-1));
+    applyCommands();
+    TEST_ASSERT_EQUAL_INT(RotatingLoop, getSelectedEffect());
+    TEST_ASSERT_TRUE(postCommand(Command_SetEffect, getEffectCount()));
+    applyCommands();
+    TEST_ASSERT_EQUAL_INT(RotatingLoop, getSelectedEffect());
+
+    postCommand(Command_SetEffect, 0);
+    applyCommands();
+}
+
+int main(int argc, char** argv) {
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_clock_scales_by_both_speeds);
+    RUN_TEST(test_speed_change_keeps_the_effect_running);
+    RUN_TEST(test_zero_speed_pauses_the_effect);
+    RUN_TEST(test_speed_stays_with_its_effect);
+    RUN_TEST(test_command_sets_the_selected_effect);
+    RUN_TEST(test_commands_apply_in_the_order_sent);
+    RUN_TEST(test_command_ignores_unknown_effects);
+    return UNITY_END();
+}
@@ -0,0 +1,339 @@
+// Streams E1.31 and Art-Net frames to the StreamReceiver over a real UDP
+// socket on localhost, the way a show controller would, and replays
+// sequences with gaps, reordering and jitter to check what ends up shown.
+//
+//   pio test -e native -f test_stream -v
+#include <unity.h>
+#include <LEDController.h>
+#include <StreamReceiver.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+const uint16_t FirstUniverse = 1;
+// three universes, the last one short
+const uint16_t LongStripPixels = 400;
+
+typedef std::vector<uint8_t> Packet;
+
+static int receiveSocket = -1;
+static int sendSocket = -1;
+static sockaddr_in receiveAddress;
+
+// What a controller sends for one universe, every pixel the same colour
+static Packet e131Packet(uint16_t universe, uint8_t sequence, RgbColor color,
+    uint16_t pixels = PixelsPerUniverse, uint8_t options = 0) {
+    const uint16_t slots = pixels * 3;
+    Packet packet(126 + slots, 0);
+    const uint8_t identifier[] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7' };
+
+    // root layer
+    packet[1] = 0x10;
+    memcpy(&packet[4], identifier, sizeof(identifier));
+    packet[16] = 0x70 | ((packet.size() - 16) >> 8);
+    packet[17] = (packet.size() - 16) & 0xff;
+    packet[21] = 0x04;
+    // framing layer
+    packet[38] = 0x70 | ((packet.size() - 38) >> 8);
+    packet[39] = (packet.size() - 38) & 0xff;
+    packet[43] = 0x02;
+    memcpy(&packet[44], "test sender", 11);
+    packet[108] = 100;
+    packet[111] = sequence;
+    packet[112] = options;
+    packet[113] = universe >> 8;
+    packet[114] = universe & 0xff;
+    // DMP layer
+    packet[115] = 0x70 | ((packet.size() - 115) >> 8);
+    packet[116] = (packet.size() - 115) & 0xff;
+    packet[117] = 0x02;
+    packet[118] = 0xa1;
+    packet[122] = 0x01;
+    packet[123] = (slots + 1) >> 8;
+    packet[124] = (slots + 1) & 0xff;
+    for (uint16_t pixel = 0; pixel < pixels; pixel++) {
+        packet[126 + pixel * 3] = color.R;
+        packet[127 + pixel * 3] = color.G;
+        packet[128 + pixel * 3] = color.B;
+    }
+    return packet;
+}
+
+static Packet artNetPacket(uint16_t universe, uint8_t sequence, RgbColor color, uint16_t pixels) {
+    const uint16_t slots = pixels * 3;
+    Packet packet(18 + slots, 0);
+    memcpy(&packet[0], "Art-Net", 8);
+    packet[9] = 0x50;
+    packet[11] = 14;
+    packet[12] = sequence;
+    packet[14] = universe & 0xff;
+    packet[15] = universe >> 8;
+    packet[16] = slots >> 8;
+    packet[17] = slots & 0xff;
+    for (uint16_t pixel = 0; pixel < pixels; pixel++) {
+        packet[18 + pixel * 3] = color.R;
+        packet[19 + pixel * 3] = color.G;
+        packet[20 + pixel * 3] = color.B;
+    }
+    return packet;
+}
+
+// Sends the packet through localhost and hands what arrives to the
+// receiver, as the network task does on the mirror
+static bool deliver(StreamReceiver& receiver, const Packet& packet) {
+    sendto(sendSocket, packet.data(), packet.size(), 0, (sockaddr*)&receiveAddress, sizeof(receiveAddress));
+
+    uint8_t buffer[1500];
+    ssize_t length = recv(receiveSocket, buffer, sizeof(buffer), 0);
+    TEST_ASSERT_EQUAL((ssize_t)packet.size(), length);
+    return receiver.Receive(buffer, length, millis());
+}
+
+static void assertFrameColor(const FrameBuffer& frame, RgbColor color) {
+    for (uint16_t pixel = 0; pixel < frame.PixelCount(); pixel++) {
+        RgbColor shown = frame.GetPixelColor(pixel);
+        TEST_ASSERT_EQUAL_UINT8(color.R, shown.R);
+        TEST_ASSERT_EQUAL_UINT8(color.G, shown.G);
+        TEST_ASSERT_EQUAL_UINT8(color.B, shown.B);
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_e131_frame_waits_out_the_latency(void) {
+    StreamReceiver receiver;
+    receiver.Begin(LongStripPixels, FirstUniverse);
+    std::vector<uint16_t> channels(LongStripPixels * FrameBuffer::ChannelsPerPixel);
+    FrameBuffer frame(channels.data(), LongStripPixels);
+
+    TEST_ASSERT_FALSE(receiver.IsActive(millis()));
+    TEST_ASSERT_TRUE(deliver(receiver, e131Packet(1, 1, RgbColor(10, 20, 30))));
+    TEST_ASSERT_TRUE(deliver(receiver, e131Packet(2, 1, RgbColor(10, 20, 30))));
+    TEST_ASSERT_TRUE(deliver(receiver, e131Packet(3, 1, RgbColor(10, 20, 30), LongStripPixels - 340)));
+    TEST_ASSERT_TRUE(receiver.IsActive(millis()));
+
+    // held back until it has waited out the latency, then swapped in whole
+    TEST_ASSERT_FALSE(receiver.Exchange(frame, millis()));
+    hostAdvanceMillis(StreamReceiver::DefaultLatency);
+    uint16_t* before = frame.Channels();
+    TEST_ASSERT_TRUE(receiver.Exchange(frame, millis()));
+    TEST_ASSERT_TRUE(frame.Channels() != before);
+    assertFrameColor(frame, RgbColor(10, 20, 30));
+
+    StreamStats stats = receiver.Stats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.packets);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.shown);
+}
+
+void test_other_universes_and_packets_are_ignored(void) {
+    StreamReceiver receiver;
+    receiver.Begin(LongStripPixels, FirstUniverse);
+
+    TEST_ASSERT_FALSE(deliver(receiver, e131Packet(4, 1, RgbColor(255, 0, 0))));
+    TEST_ASSERT_FALSE(deliver(receiver, e131Packet(0, 1, RgbColor(255, 0, 0))));
+    // preview data is for visualisers
+    TEST_ASSERT_FALSE(deliver(receiver, e131Packet(1, 1, RgbColor(255, 0, 0), PixelsPerUniverse, 0x80)));
+    Packet junk(200, 0x55);
+    TEST_ASSERT_FALSE(deliver(receiver, junk));
+    TEST_ASSERT_FALSE(receiver.IsActive(millis()));
+}
+
+void test_sequence_gaps_and_late_packets_are_counted(void) {
+    StreamReceiver receiver;
+    receiver.Begin(PixelsPerUniverse, FirstUniverse);
+
+    // 252 and 253 go missing, then 253 turns up after 254, and 1 and 2
+    // are lost after the counter wraps
+    const uint8_t replay[] = { 250, 251, 254, 253, 255, 0, 3 };
+    for (size_t index = 0; index < sizeof(replay); index++) {
+        deliver(receiver, e131Packet(1, replay[index], RgbColor(1, 2, 3)));
+    }
+
+    StreamStats stats = receiver.Stats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.outOfOrder);
+}
+
+void test_incomplete_frames_are_dropped(void) {
+    StreamReceiver receiver;
+    receiver.Begin(LongStripPixels, FirstUniverse);
+    std::vector<uint16_t> channels(LongStripPixels * FrameBuffer::ChannelsPerPixel);
+    FrameBuffer frame(channels.data(), LongStripPixels);
+
+    // universe 2 of the first frame is lost
+    deliver(receiver, e131Packet(1, 1, RgbColor(255, 0, 0)));
+    deliver(receiver, e131Packet(3, 1, RgbColor(255, 0, 0), LongStripPixels - 340));
+    deliver(receiver, e131Packet(1, 2, RgbColor(0, 255, 0)));
+    deliver(receiver, e131Packet(2, 2, RgbColor(0, 255, 0)));
+    deliver(receiver, e131Packet(3, 2, RgbColor(0, 255, 0), LongStripPixels - 340));
+
+    hostAdvanceMillis(StreamReceiver::DefaultLatency);
+    TEST_ASSERT_TRUE(receiver.Exchange(frame, millis()));
+    assertFrameColor(frame, RgbColor(0, 255, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, receiver.Stats().incomplete);
+    TEST_ASSERT_EQUAL_UINT32(1, receiver.Stats().frames);
+}
+
+void test_jitter_is_absorbed_by_the_latency(void) {
+    StreamReceiver receiver;
+    receiver.Begin(PixelsPerUniverse, FirstUniverse);
+    std::vector<uint16_t> channels(PixelsPerUniverse * FrameBuffer::ChannelsPerPixel);
+    FrameBuffer frame(channels.data(), PixelsPerUniverse);
+
+    // a frame sent every 25 ms, the later ones held up on the way by up to
+    // 20 ms, with the render loop checking every ms
+    const uint8_t FrameCount = 16;
+    const uint32_t SendInterval = 25;
+    const uint32_t delays[FrameCount] = { 0, 0, 0, 0, 0, 0, 0, 0, 15, 5, 20, 0, 10, 18, 3, 0 };
+    uint32_t shownAt[FrameCount] = { 0 };
+    const uint32_t start = millis();
+    uint8_t sent = 0;
+    for (uint32_t elapsed = 0; elapsed < FrameCount * SendInterval + 100; elapsed++) {
+        hostSetMillis(start + elapsed);
+        if (sent < FrameCount && elapsed >= sent * SendInterval + delays[sent]) {
+            deliver(receiver, artNetPacket(1, sent + 1, RgbColor(sent, 0, 0), PixelsPerUniverse));
+            sent++;
+        }
+        if (receiver.Exchange(frame, millis())) {
+            shownAt[frame.GetPixelColor(0).R] = elapsed;
+        }
+    }
+
+    // however late each arrived, they go out as evenly as they were sent
+    for (uint8_t index = 8; index < FrameCount; index++) {
+        TEST_ASSERT_INT_WITHIN(1, SendInterval, shownAt[index] - shownAt[index - 1]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(FrameCount, receiver.Stats().shown);
+    TEST_ASSERT_EQUAL_UINT32(0, receiver.Stats().skipped);
+}
+
+void test_a_late_render_loop_skips_to_the_newest_frame(void) {
+    StreamReceiver receiver;
+    receiver.Begin(PixelsPerUniverse, FirstUniverse);
+    receiver.SetLatency(0);
+    std::vector<uint16_t> channels(PixelsPerUniverse * FrameBuffer::ChannelsPerPixel);
+    FrameBuffer frame(channels.data(), PixelsPerUniverse);
+
+    for (uint8_t index = 1; index <= 2; index++) {
+        deliver(receiver, artNetPacket(1, index, RgbColor(index, 0, 0), PixelsPerUniverse));
+    }
+    TEST_ASSERT_TRUE(receiver.Exchange(frame, millis()));
+    TEST_ASSERT_EQUAL_UINT8(2, frame.GetPixelColor(0).R);
+    TEST_ASSERT_EQUAL_UINT32(1, receiver.Stats().skipped);
+}
+
+void test_stream_replaces_the_effect_until_it_times_out(void) {
+    // plain output so the wire holds exactly what was streamed
+    OutputSettings plain = { 1.0f, 255, RgbColor(255, 255, 255), false };
+    setOutputSettings(plain);
+    setTransitionTime(0);
+    StreamReceiver& receiver = getStreamReceiver();
+
+    animationSelector(0);
+    showFrame();
+    const uint16_t pixels = getPixelCount();
+    deliver(receiver, e131Packet(1, 1, RgbColor(0, 0, 200), pixels));
+    hostAdvanceMillis(StreamReceiver::DefaultLatency);
+    animationSelector(0);
+    showFrame();
+
+    const HostWire& wire = hostWire();
+    TEST_ASSERT_EQUAL(pixels * 3, wire.size);
+    for (uint16_t pixel = 0; pixel < pixels; pixel++) {
+        // GRB on the wire
+        TEST_ASSERT_EQUAL_UINT8(0, wire.data[pixel * 3]);
+        TEST_ASSERT_EQUAL_UINT8(0, wire.data[pixel * 3 + 1]);
+        TEST_ASSERT_EQUAL_UINT8(200, wire.data[pixel * 3 + 2]);
+    }
+
+    // nothing more arrives, the selected effect, off, comes back
+    hostAdvanceMillis(StreamReceiver::DefaultTimeout);
+    animationSelector(0);
+    showFrame();
+    for (size_t index = 0; index < wire.size; index++) {
+        TEST_ASSERT_EQUAL_UINT8(0, wire.data[index]);
+    }
+}
+
+void test_streamed_values_skip_the_curve(void) {
+    // the default curve and dithering, a controller has already corrected
+    // what it sends, so it goes out as it came in frame after frame
+    OutputSettings defaults = { 1.0f / 0.45f, 255, RgbColor(255, 255, 255), true };
+    setOutputSettings(defaults);
+    setTransitionTime(0);
+    StreamReceiver& receiver = getStreamReceiver();
+    const uint16_t pixels = getPixelCount();
+
+    animationSelector(0);
+    showFrame();
+    const HostWire& wire = hostWire();
+    for (uint8_t sequence = 20; sequence < 30; sequence++) {
+        deliver(receiver, e131Packet(1, sequence, RgbColor(0x80, 0x01, 0xfe), pixels));
+        hostAdvanceMillis(StreamReceiver::DefaultLatency);
+        animationSelector(0);
+        showFrame();
+        for (uint16_t pixel = 0; pixel < pixels; pixel++) {
+            // GRB on the wire
+            TEST_ASSERT_EQUAL_UINT8(0x01, wire.data[pixel * 3]);
+            TEST_ASSERT_EQUAL_UINT8(0x80, wire.data[pixel * 3 + 1]);
+            TEST_ASSERT_EQUAL_UINT8(0xfe, wire.data[pixel * 3 + 2]);
+        }
+    }
+
+    hostAdvanceMillis(StreamReceiver::DefaultTimeout);
+    animationSelector(0);
+    showFrame();
+}
+
+void test_terminated_stream_falls_back_at_once(void) {
+    StreamReceiver& receiver = getStreamReceiver();
+    const uint16_t pixels = getPixelCount();
+
+    deliver(receiver, e131Packet(1, 10, RgbColor(0, 0, 200), pixels));
+    TEST_ASSERT_TRUE(receiver.IsActive(millis()));
+    // stream_terminated in the options
+    deliver(receiver, e131Packet(1, 11, RgbColor(0, 0, 200), pixels, 0x40));
+    TEST_ASSERT_FALSE(receiver.IsActive(millis()));
+}
+
+int main(int argc, char** argv) {
+    receiveSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    sendSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&receiveAddress, 0, sizeof(receiveAddress));
+    receiveAddress.sin_family = AF_INET;
+    receiveAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    receiveAddress.sin_port = 0;
+    bind(receiveSocket, (sockaddr*)&receiveAddress, sizeof(receiveAddress));
+    socklen_t addressLength = sizeof(receiveAddress);
+    getsockname(receiveSocket, (sockaddr*)&receiveAddress, &addressLength);
+    // a lost localhost packet fails the test rather than hanging it
+    timeval timeout = { 1, 0 };
+    setsockopt(receiveSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    initStrip();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_e131_frame_waits_out_the_latency);
+    RUN_TEST(test_other_universes_and_packets_are_ignored);
+    RUN_TEST(test_sequence_gaps_and_late_packets_are_counted);
+    RUN_TEST(test_incomplete_frames_are_dropped);
+    RUN_TEST(test_jitter_is_absorbed_by_the_latency);
+    RUN_TEST(test_a_late_render_loop_skips_to_the_newest_frame);
+    RUN_TEST(test_stream_replaces_the_effect_until_it_times_out);
+    RUN_TEST(test_streamed_values_skip_the_curve);
+    RUN_TEST(test_terminated_stream_falls_back_at_once);
+    int failures = UNITY_END();
+
+    close(receiveSocket);
+    close(sendSocket);
+    return failures;
+}
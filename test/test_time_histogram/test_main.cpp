@@ -0,0 +1,118 @@
+// Checks TimeHistogram's buckets and percentiles, which the p50 and p99
+// frame and request times on /metrics come from: exact below 8, never
+// more than an eighth over above that, and everything from 2^24 up in the
+// last bucket.
+//
+//   pio test -e native -f test_time_histogram -v
+#include <unity.h>
+#include <TimeHistogram.h>
+
+// the top of the bucket value falls in, what a percentile landing in that
+// bucket reads as. The larger value recorded after keeps the top from
+// being clamped to the maximum.
+static uint32_t bucketTopOf(uint32_t value) {
+    TimeHistogram histogram;
+    histogram.Record(value);
+    histogram.Record(value);
+    histogram.Record(UINT32_MAX);
+    return histogram.Percentile(50);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_empty_histogram(void) {
+    TimeHistogram histogram;
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Count());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Percentile(0));
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Percentile(50));
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Percentile(100));
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Min());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Max());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Average());
+
+    // and empty again after a reset
+    histogram.Record(1234);
+    histogram.Reset();
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Percentile(99));
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.Min());
+}
+
+void test_boundary_values(void) {
+    // a bucket each below 8
+    TEST_ASSERT_EQUAL_UINT32(0, bucketTopOf(0));
+    TEST_ASSERT_EQUAL_UINT32(7, bucketTopOf(7));
+    // still one wide from 8 to 15, then two wide
+    TEST_ASSERT_EQUAL_UINT32(8, bucketTopOf(8));
+    TEST_ASSERT_EQUAL_UINT32(15, bucketTopOf(15));
+    TEST_ASSERT_EQUAL_UINT32(17, bucketTopOf(16));
+    // the last bucket with a top, then the one without
+    TEST_ASSERT_EQUAL_UINT32((1UL << 24) - 1, bucketTopOf((1UL << 24) - 1));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bucketTopOf(1UL << 24));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, bucketTopOf(UINT32_MAX));
+
+    // and past 2^24 a percentile is the largest value recorded
+    TimeHistogram histogram;
+    histogram.Record(1UL << 24);
+    histogram.Record(20000000);
+    TEST_ASSERT_EQUAL_UINT32(20000000, histogram.Percentile(50));
+    TEST_ASSERT_EQUAL_UINT32(1UL << 24, histogram.Min());
+}
+
+void test_bucket_top_within_an_eighth(void) {
+    // every value is at or below its bucket's top, by at most an eighth
+    for (uint32_t value = 0; value < (1UL << 24); value = value + 1 + value / 61) {
+        const uint32_t top = bucketTopOf(value);
+        TEST_ASSERT_TRUE(top >= value);
+        TEST_ASSERT_TRUE(top - value <= value / 8);
+    }
+}
+
+void test_uniform_distribution(void) {
+    TimeHistogram histogram;
+    for (uint32_t value = 1; value <= 1000; value++) {
+        histogram.Record(value);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.Count());
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.Min());
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.Max());
+    TEST_ASSERT_EQUAL_UINT32(500, histogram.Average());
+
+    const uint32_t p50 = histogram.Percentile(50);
+    const uint32_t p99 = histogram.Percentile(99);
+    TEST_ASSERT_TRUE(p50 >= 500 && p50 <= 500 + 500 / 8);
+    TEST_ASSERT_TRUE(p99 >= 990 && p99 <= 1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, histogram.Percentile(100));
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.Percentile(0));
+}
+
+void test_frame_times_with_a_slow_tail(void) {
+    // 98 frames of 3 ms and 2 of 40 ms, as a frame rate with the odd WiFi
+    // hiccup looks: the median is the usual frame, p99 the hiccup
+    TimeHistogram histogram;
+    for (uint32_t frame = 0; frame < 98; frame++) {
+        histogram.Record(3000);
+    }
+    histogram.Record(40000);
+    histogram.Record(40000);
+
+    const uint32_t p50 = histogram.Percentile(50);
+    const uint32_t p98 = histogram.Percentile(98);
+    const uint32_t p99 = histogram.Percentile(99);
+    TEST_ASSERT_TRUE(p50 >= 3000 && p50 <= 3000 + 3000 / 8);
+    TEST_ASSERT_EQUAL_UINT32(p50, p98);
+    TEST_ASSERT_EQUAL_UINT32(40000, p99);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_histogram);
+    RUN_TEST(test_boundary_values);
+    RUN_TEST(test_bucket_top_within_an_eighth);
+    RUN_TEST(test_uniform_distribution);
+    RUN_TEST(test_frame_times_with_a_slow_tail);
+    return UNITY_END();
+}
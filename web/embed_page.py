@@ -0,0 +1,51 @@
+# Compresses web/index.html into include/IndexPage.h before each build, so
+# the control page is served from flash already gzipped with an ETag and
+# nothing about it is worked out per request.
+#
+# Runs from platformio.ini as an extra script, or on its own with
+#   python web/embed_page.py
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")
+    root = env.subst("$PROJECT_DIR")
+except NameError:
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+source = os.path.join(root, "web", "index.html")
+target = os.path.join(root, "include", "IndexPage.h")
+
+with open(source, "rb") as page:
+    html = page.read()
+
+# mtime 0 so the same page always compresses to the same bytes and ETag
+compressed = gzip.compress(html, compresslevel=9, mtime=0)
+etag = hashlib.sha1(compressed).hexdigest()[:16]
+
+lines = [
+    "// Generated from web/index.html by web/embed_page.py, edit the page and rebuild",
+    "#ifndef INDEX_PAGE_H",
+    "#define INDEX_PAGE_H",
+    "",
+    "#include <Arduino.h>",
+    "",
+    "const char IndexPageETag[] = \"\\\"%s\\\"\";" % etag,
+    "const size_t IndexPageSize = %d;" % len(compressed),
+    "const uint8_t IndexPage[] PROGMEM = {",
+]
+for start in range(0, len(compressed), 16):
+    row = compressed[start:start + 16]
+    lines.append("    " + ", ".join("0x%02x" % byte for byte in row) + ",")
+lines += ["};", "", "#endif", ""]
+header = "\n".join(lines)
+
+# only touch the header when the page changed, so it doesn't force a rebuild
+existing = None
+if os.path.exists(target):
+    with open(target) as current:
+        existing = current.read()
+if existing != header:
+    with open(target, "w") as output:
+        output.write(header)